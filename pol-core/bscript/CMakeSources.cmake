@@ -257,6 +257,8 @@ set (bscript_sources    # sorted !
   compiler/optimizer/Optimizer.h
   compiler/optimizer/ReferencedFunctionGatherer.cpp
   compiler/optimizer/ReferencedFunctionGatherer.h
+  compiler/optimizer/SuperinstructionOptimizer.cpp
+  compiler/optimizer/SuperinstructionOptimizer.h
   compiler/optimizer/UnaryOperatorOptimizer.cpp
   compiler/optimizer/UnaryOperatorOptimizer.h
   compiler/optimizer/ValueConsumerOptimizer.cpp
@@ -307,6 +309,7 @@ set (bscript_sources    # sorted !
   escrutil.h
   execmodl.cpp
   execmodl.h
+  execops.h
   exectype.h
   executor.cpp
   executor.h
@@ -328,6 +331,8 @@ set (bscript_sources    # sorted !
   options.h
   parser.cpp
   parser.h
+  scriptsampler.cpp
+  scriptsampler.h
   str.cpp 
   symcont.cpp
   symcont.h
@@ -50,6 +50,7 @@ class BObjectRef;
 class ContIterator;
 class Executor;
 class Instruction;
+struct InlineCache;
 
 class BLong;
 class Double;
@@ -312,6 +313,8 @@ public:
   virtual BObjectRef set_member( const char* membername, BObjectImp* valueimp, bool copy );
   virtual BObjectRef get_member( const char* membername );
   virtual BObjectRef get_member_id( const int id );                                   // test id
+  // get_member_id of a single call site, which may remember its lookup in cache
+  virtual BObjectRef get_member_id_cached( const int id, InlineCache& cache );
   virtual BObjectRef set_member_id( const int id, BObjectImp* valueimp, bool copy );  // test id
 
   virtual BObjectRef OperSubscript( const BObject& obj );
@@ -512,6 +515,10 @@ public:
 
   NameCont name_arr;
   Cont ref_arr;
+  // running foreach loops, their reference doesn't make the array shared
+  unsigned int iterators = 0;
+  // an element reference was handed out, the array may only be shared once it is gone again
+  bool elements_escaped = false;
 
   ObjArray();
   ObjArray( const ObjArray& i );  // copy constructor
@@ -590,6 +597,7 @@ public:
   virtual size_t sizeEstimate() const override;
 
   int value() const { return lval_; }
+  void setvalue( int lval ) { lval_ = lval; }
   int increment() { return ++lval_; }
 
 public:  // Class Machinery
@@ -713,6 +721,7 @@ public:
   virtual size_t sizeEstimate() const override;
 
   double value() const { return dval_; }
+  void setvalue( double dval ) { dval_ = dval; }
   void copyvalue( const Double& dbl ) { dval_ = dbl.dval_; }
   double increment() { return ++dval_; }
 
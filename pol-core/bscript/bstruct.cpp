@@ -120,6 +120,7 @@ class BStructIterator final : public ContIterator
 {
 public:
   BStructIterator( BStruct* pDict, BObject* pIterVal );
+  virtual ~BStructIterator();
   virtual BObject* step() override;
 
 private:
@@ -136,6 +137,11 @@ BStructIterator::BStructIterator( BStruct* pStruct, BObject* pIterVal )
       key( "" ),
       m_First( true )
 {
+  ++m_pStruct->iterators_;
+}
+BStructIterator::~BStructIterator()
+{
+  --m_pStruct->iterators_;
 }
 
 BObject* BStructIterator::step()
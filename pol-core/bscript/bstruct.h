@@ -49,6 +49,11 @@ public:
 
   typedef std::map<std::string, BObjectRef, Clib::ci_cmp_pred> Contents;
   const Contents& contents() const;
+  // running foreach loops, their reference doesn't make the container shared
+  unsigned int iterators() const { return iterators_; }
+  // an element reference was handed out, the container may only be shared once it is gone again
+  bool elements_escaped() const { return elements_escaped_; }
+  void set_elements_escaped( bool escaped ) { elements_escaped_ = escaped; }
 
 protected:
   explicit BStruct( const BStruct& other, BObjectType type );
@@ -85,6 +90,8 @@ protected:
 
 private:
   Contents contents_;
+  unsigned int iterators_ = 0;
+  bool elements_escaped_ = false;
   BStruct& operator=( const BStruct& );  // not implemented
 };
 }
@@ -15,6 +15,7 @@
 #include "compiler/file/SourceFileIdentifier.h"
 #include "compiler/model/CompilerWorkspace.h"
 #include "compiler/model/FlowControlLabel.h"
+#include "compiler/optimizer/SuperinstructionOptimizer.h"
 #include "compiler/representation/CompiledScript.h"
 #include "compiler/representation/ExportedFunction.h"
 #include "compiler/representation/ModuleDescriptor.h"
@@ -57,6 +58,13 @@ std::unique_ptr<CompiledScript> CodeGenerator::generate(
 
   generator.generate_instructions( *workspace );
 
+  // not in comparison mode, the original compiler knows nothing about superinstructions
+  if ( !legacy_function_order )
+  {
+    SuperinstructionOptimizer superinstruction_optimizer( code, data, exported_functions );
+    superinstruction_optimizer.optimize();
+  }
+
   std::vector<ModuleDescriptor> module_descriptors =
       module_declaration_registrar.take_module_descriptors();
 
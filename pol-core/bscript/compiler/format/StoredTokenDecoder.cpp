@@ -387,6 +387,14 @@ void StoredTokenDecoder::decode_to( const StoredToken& tkn, fmt::Writer& w )
     w << "peek at top of stack; skip " << tkn.offset
       << " instructions if true, otherwise consume it";
     break;
+  case INS_LOCAL_LONG_COMPARE_JMPIFFALSE:
+  case INS_LOCAL_LOCAL_COMPARE_JMPIFFALSE:
+    w << "local variable #" << tkn.offset << "; superinstruction: compare, if false goto";
+    break;
+  case INS_LOCAL_LONG_ARITH_ASSIGN:
+  case INS_LOCAL_LOCAL_ARITH_ASSIGN:
+    w << "local variable #" << tkn.offset << "; superinstruction: arithmetic, assign local";
+    break;
 
   default:
     w << "id=0x" << fmt::hex( tkn.id ) << " type=" << tkn.type << " offset=" << tkn.offset
@@ -0,0 +1,162 @@
+#include "SuperinstructionOptimizer.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "StoredToken.h"
+#include "compiler/representation/ExportedFunction.h"
+#include "tokens.h"
+
+namespace Pol::Bscript::Compiler
+{
+namespace
+{
+bool is_comparison( unsigned char id )
+{
+  switch ( id )
+  {
+  case TOK_LESSTHAN:
+  case TOK_LESSEQ:
+  case TOK_GRTHAN:
+  case TOK_GREQ:
+  case TOK_EQUAL:
+  case TOK_NEQ:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool is_integer_arithmetic( unsigned char id )
+{
+  return id == TOK_ADD || id == TOK_SUBTRACT || id == TOK_MULT;
+}
+}  // namespace
+
+SuperinstructionOptimizer::SuperinstructionOptimizer( CodeSection& code, const DataSection& data,
+                                                      const ExportedFunctions& exported_functions )
+  : code( code ), data( data ), exported_functions( exported_functions )
+{
+}
+
+unsigned SuperinstructionOptimizer::optimize()
+{
+  auto targets = find_jump_targets();
+
+  unsigned fused = 0;
+  for ( unsigned i = 0; i + 3 < code.size(); ++i )
+  {
+    if ( code[i].id != TOK_LOCALVAR )
+      continue;
+    const unsigned char rhs = code[i + 1].id;
+    const unsigned char op = code[i + 2].id;
+    const unsigned char last = code[i + 3].id;
+    if ( rhs != TOK_LONG && rhs != TOK_LOCALVAR )
+      continue;
+
+    BTokenId superinstruction;
+    if ( is_comparison( op ) && last == RSV_JMPIFFALSE )
+    {
+      superinstruction = ( rhs == TOK_LONG ) ? INS_LOCAL_LONG_COMPARE_JMPIFFALSE
+                                             : INS_LOCAL_LOCAL_COMPARE_JMPIFFALSE;
+    }
+    else if ( is_integer_arithmetic( op ) && last == INS_ASSIGN_LOCALVAR )
+    {
+      superinstruction =
+          ( rhs == TOK_LONG ) ? INS_LOCAL_LONG_ARITH_ASSIGN : INS_LOCAL_LOCAL_ARITH_ASSIGN;
+    }
+    else
+    {
+      continue;
+    }
+    if ( is_jump_target_within( targets, i + 1, i + 3 ) )
+      continue;
+
+    code[i].id = static_cast<unsigned char>( superinstruction );
+    ++fused;
+    i += 3;
+  }
+  return fused;
+}
+
+std::vector<bool> SuperinstructionOptimizer::find_jump_targets() const
+{
+  std::vector<bool> targets( code.size() + 1, false );
+  auto mark = [&targets]( unsigned address ) {
+    if ( address < targets.size() )
+      targets[address] = true;
+  };
+
+  for ( unsigned address = 0; address < code.size(); ++address )
+  {
+    const StoredToken& tkn = code[address];
+    switch ( tkn.id )
+    {
+    case RSV_JMPIFFALSE:
+    case RSV_JMPIFTRUE:
+    case RSV_GOTO:
+    case INS_INITFOREACH:
+    case INS_STEPFOREACH:
+    case INS_INITFOR:
+    case INS_NEXTFOR:
+    case TOK_FUNCREF:
+      mark( tkn.offset );
+      break;
+    case CTRL_JSR_USERFUNC:
+      mark( tkn.offset );
+      mark( address + 1 );  // return address
+      break;
+    case INS_SKIPIFTRUE_ELSE_CONSUME:
+      mark( address + 1 + tkn.offset );
+      break;
+    case INS_CASEJMP:
+      add_case_jump_targets( tkn.offset, targets );
+      break;
+    default:
+      break;
+    }
+  }
+  for ( auto& exported_function : exported_functions )
+    mark( exported_function.entrypoint_program_counter );
+
+  return targets;
+}
+
+void SuperinstructionOptimizer::add_case_jump_targets( unsigned data_offset,
+                                                       std::vector<bool>& targets ) const
+{
+  // same layout as written by CaseJumpDataBlock and read by Executor::ins_casejmp
+  for ( ;; )
+  {
+    if ( data_offset + 3 > data.size() )
+      throw std::runtime_error( "case jump table at data offset " +
+                                std::to_string( data_offset ) + " is truncated" );
+    uint16_t address;
+    std::memcpy( &address, &data[data_offset], sizeof address );
+    auto type = static_cast<unsigned char>( data[data_offset + 2] );
+    data_offset += 3;
+    if ( address < targets.size() )
+      targets[address] = true;
+
+    if ( type == CASE_TYPE_LONG )
+      data_offset += 4;
+    else if ( type == CASE_TYPE_DEFAULT )
+      break;
+    else
+      data_offset += type;
+  }
+}
+
+bool SuperinstructionOptimizer::is_jump_target_within( const std::vector<bool>& targets,
+                                                       unsigned first, unsigned last ) const
+{
+  for ( unsigned address = first; address <= last; ++address )
+  {
+    if ( targets[address] )
+      return true;
+  }
+  return false;
+}
+
+}  // namespace Pol::Bscript::Compiler
@@ -0,0 +1,40 @@
+#ifndef POLSERVER_SUPERINSTRUCTIONOPTIMIZER_H
+#define POLSERVER_SUPERINSTRUCTIONOPTIMIZER_H
+
+#include <vector>
+
+#include "compiler/representation/CompiledScript.h"
+
+namespace Pol::Bscript::Compiler
+{
+// Peephole pass over the generated instructions.  Fuses the sequences that make up most
+// loop conditions and counter updates into one superinstruction:
+//
+//   localvar, long|localvar, <comparison>, jmpiffalse
+//   localvar, long|localvar, + - *, assign localvar
+//
+// The first instruction gets replaced, the others stay where they are (the executor skips
+// them), so no address, jump target or debug information needs to be relocated.
+// A sequence is only fused if no jump lands inside of it.
+class SuperinstructionOptimizer
+{
+public:
+  SuperinstructionOptimizer( CodeSection&, const DataSection&, const ExportedFunctions& );
+
+  // returns the number of fused sequences
+  unsigned optimize();
+
+private:
+  std::vector<bool> find_jump_targets() const;
+  void add_case_jump_targets( unsigned data_offset, std::vector<bool>& targets ) const;
+  bool is_jump_target_within( const std::vector<bool>& targets, unsigned first,
+                              unsigned last ) const;
+
+  CodeSection& code;
+  const DataSection& data;
+  const ExportedFunctions& exported_functions;
+};
+
+}  // namespace Pol::Bscript::Compiler
+
+#endif  // POLSERVER_SUPERINSTRUCTIONOPTIMIZER_H
@@ -64,6 +64,7 @@ class BDictionaryIterator final : public ContIterator
 {
 public:
   BDictionaryIterator( BDictionary* pDict, BObject* pIterVal );
+  virtual ~BDictionaryIterator();
   virtual BObject* step() override;
 
 private:
@@ -81,6 +82,11 @@ BDictionaryIterator::BDictionaryIterator( BDictionary* pDict, BObject* pIterVal
       m_Key( UninitObject::create() ),
       m_First( true )
 {
+  ++m_pDict->iterators_;
+}
+BDictionaryIterator::~BDictionaryIterator()
+{
+  --m_pDict->iterators_;
 }
 
 BObject* BDictionaryIterator::step()
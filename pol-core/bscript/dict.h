@@ -45,6 +45,11 @@ public:
 
   typedef std::map<BObject, BObjectRef> Contents;
   const Contents& contents() const;
+  // running foreach loops, their reference doesn't make the container shared
+  unsigned int iterators() const { return iterators_; }
+  // an element reference was handed out, the container may only be shared once it is gone again
+  bool elements_escaped() const { return elements_escaped_; }
+  void set_elements_escaped( bool escaped ) { elements_escaped_ = escaped; }
 
 protected:
   BDictionary( std::istream& is, unsigned size, BObjectType type = OTDictionary );
@@ -81,6 +86,8 @@ protected:
 
 private:
   Contents contents_;
+  unsigned int iterators_ = 0;
+  bool elements_escaped_ = false;
 
   // not implemented:
   BDictionary& operator=( const BDictionary& );
@@ -9,6 +9,7 @@
 #define BSCRIPT_EPROG_H
 
 #include <iosfwd>
+#include <memory>
 #include <stdio.h>
 #include <string>
 #include <vector>
@@ -34,11 +35,12 @@ class FunctionalityModule;
 class Instruction
 {
 public:
-  Instruction( ExecInstrFunc f ) : token(), func( f ), cycles( 0 ) {}
-  Instruction() : token(), func( 0 ), cycles( 0 ) {}
+  Instruction( ExecInstrFunc f ) : token(), func( f ), cycles( 0 ), cache() {}
+  Instruction() : token(), func( 0 ), cycles( 0 ), cache() {}
   Token token;
   ExecInstrFunc func;
   mutable unsigned int cycles;
+  mutable InlineCache cache;
 };
 
 struct EPDbgInstr
@@ -138,6 +140,10 @@ public:
   u64 instr_cycles;  // FIXME need an enable-profiling flag
   Plib::Package const* pkg;
   std::vector<Instruction> instr;
+  std::vector<unsigned char> opcodes;  // Executor::Opcode per instruction, for execInstrs
+  // distinct string literals, the lval of a TOK_STRING instruction is its index. String values
+  // created from a literal share its buffer until they get modified.
+  std::vector<std::shared_ptr<std::string>> string_literals;
 
   // debug data:
   bool debug_loaded;
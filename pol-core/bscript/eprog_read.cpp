@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <exception>
 #include <string>
+#include <unordered_map>
 
 #include "../clib/logfacility.h"
 #include "../clib/rawtypes.h"
@@ -144,6 +145,8 @@ int EScriptProgram::create_instructions()
 {
   int nLines = tokens.length() / sizeof( StoredToken );
   instr.resize( nLines );  // = new Instruction[ nLines ];
+  opcodes.resize( nLines );
+  std::unordered_map<std::string, int> literal_index;
 
   for ( int i = 0; i < nLines; i++ )
   {
@@ -151,8 +154,19 @@ int EScriptProgram::create_instructions()
     if ( _readToken( ins.token, i ) )
       return -1;
 
+    if ( ins.token.id == TOK_STRING )
+    {
+      std::string literal( ins.token.tokval() != nullptr ? ins.token.tokval() : "" );
+      auto res = literal_index.emplace( literal, static_cast<int>( string_literals.size() ) );
+      if ( res.second )
+        string_literals.push_back( std::make_shared<std::string>( std::move( literal ) ) );
+      ins.token.lval = res.first->second;
+    }
+
     // executor only:
-    ins.func = Executor::GetInstrFunc( ins.token );
+    Executor::Opcode opcode = Executor::GetInstrOpcode( ins.token );
+    opcodes[i] = opcode;
+    ins.func = Executor::GetInstrFunc( opcode );
   }
   return 0;
 }
@@ -295,6 +309,10 @@ int EScriptProgram::_readToken( Token& token, unsigned position ) const
   case INS_SET_MEMBER_ID_UNPLUSPLUS_POST:
   case INS_SET_MEMBER_ID_UNMINUSMINUS_POST:
   case INS_SKIPIFTRUE_ELSE_CONSUME:
+  case INS_LOCAL_LONG_COMPARE_JMPIFFALSE:
+  case INS_LOCAL_LOCAL_COMPARE_JMPIFFALSE:
+  case INS_LOCAL_LONG_ARITH_ASSIGN:
+  case INS_LOCAL_LOCAL_ARITH_ASSIGN:
     token.lval = st.offset;
     return 0;
   case TOK_FUNCREF:
@@ -21,5 +21,7 @@ std::atomic<int> eobject_imp_constructions( 0 );
 int escript_program_count = 0;
 u64 escript_instr_cycles = 0;
 int escript_execinstr_calls = 0;
+u64 escript_inline_cache_hits = 0;
+u64 escript_inline_cache_misses = 0;
 }
 }
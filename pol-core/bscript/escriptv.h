@@ -26,6 +26,9 @@ extern int escript_program_count;
 
 extern u64 escript_instr_cycles;
 extern int escript_execinstr_calls;
+
+extern u64 escript_inline_cache_hits;
+extern u64 escript_inline_cache_misses;
 }
 }
 #endif
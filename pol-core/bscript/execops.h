@@ -0,0 +1,123 @@
+/** @file
+ *
+ * @par History
+ */
+
+// List of all instruction handlers of the Executor, included with EXEC_OP defined. The position
+// in this list is the predecoded opcode (Executor::Opcode) of an instruction.
+// Handlers which call into modules or objects may block or change the script state
+// (sleep, wait_for_event, set_critical, ...), they use EXEC_OP_YIELD and end a batch of
+// Executor::execInstrs so that the scheduler sees the change.
+// No include guard, this file is meant to be included multiple times.
+
+#ifndef EXEC_OP_YIELD
+#define EXEC_OP_YIELD( name ) EXEC_OP( name )
+#endif
+
+EXEC_OP( initforeach2 )
+EXEC_OP( stepforeach2 )
+EXEC_OP( initfor )
+EXEC_OP( nextfor )
+EXEC_OP( casejmp )
+EXEC_OP( jmpiftrue )
+EXEC_OP( jmpiffalse )
+EXEC_OP( makeLocal )
+EXEC_OP( globalvar )
+EXEC_OP( localvar )
+EXEC_OP( long )
+EXEC_OP( double )
+EXEC_OP( string )
+EXEC_OP( error )
+EXEC_OP( struct )
+EXEC_OP( array )
+EXEC_OP( dictionary )
+EXEC_OP( funcref )
+EXEC_OP( uninit )
+EXEC_OP( ident )
+EXEC_OP( assign_globalvar )
+EXEC_OP( assign_localvar )
+EXEC_OP( assign_consume )
+EXEC_OP( consume )
+EXEC_OP( assign )
+EXEC_OP( array_assign )
+EXEC_OP( array_assign_consume )
+EXEC_OP( multisubscript )
+EXEC_OP( multisubscript_assign )
+EXEC_OP( get_member )
+EXEC_OP( set_member )
+EXEC_OP( set_member_consume )
+EXEC_OP( get_member_id )
+EXEC_OP( set_member_id )
+EXEC_OP( set_member_id_consume )
+EXEC_OP( set_member_id_consume_plusequal )
+EXEC_OP( set_member_id_consume_minusequal )
+EXEC_OP( set_member_id_consume_timesequal )
+EXEC_OP( set_member_id_consume_divideequal )
+EXEC_OP( set_member_id_consume_modulusequal )
+EXEC_OP( add )
+EXEC_OP( subtract )
+EXEC_OP( div )
+EXEC_OP( mult )
+EXEC_OP( modulus )
+EXEC_OP( insert_into )
+EXEC_OP( plusequal )
+EXEC_OP( minusequal )
+EXEC_OP( timesequal )
+EXEC_OP( divideequal )
+EXEC_OP( modulusequal )
+EXEC_OP( lessthan )
+EXEC_OP( lessequal )
+EXEC_OP( goto )
+EXEC_OP( arraysubscript )
+EXEC_OP( equal )
+EXEC_OP_YIELD( func )
+EXEC_OP_YIELD( call_method )
+EXEC_OP_YIELD( call_method_id )
+EXEC_OP( statementbegin )
+EXEC_OP( makelocal )
+EXEC_OP( jsr_userfunc )
+EXEC_OP( pop_param )
+EXEC_OP( pop_param_byref )
+EXEC_OP( get_arg )
+EXEC_OP( leave_block )
+EXEC_OP( gosub )
+EXEC_OP( return )
+EXEC_OP( exit )
+EXEC_OP( declareArray )
+EXEC_OP( unminus )
+EXEC_OP( nop )
+EXEC_OP( logical_not )
+EXEC_OP( bitwise_not )
+EXEC_OP( bitshift_right )
+EXEC_OP( bitshift_left )
+EXEC_OP( bitwise_and )
+EXEC_OP( bitwise_xor )
+EXEC_OP( bitwise_or )
+EXEC_OP( notequal )
+EXEC_OP( greaterthan )
+EXEC_OP( greaterequal )
+EXEC_OP( logical_and )
+EXEC_OP( logical_or )
+EXEC_OP( addmember )
+EXEC_OP( removemember )
+EXEC_OP( checkmember )
+EXEC_OP( dictionary_addmember )
+EXEC_OP( in )
+EXEC_OP( addmember2 )
+EXEC_OP( addmember_assign )
+EXEC_OP( progend )
+EXEC_OP( unplusplus )
+EXEC_OP( unminusminus )
+EXEC_OP( unplusplus_post )
+EXEC_OP( unminusminus_post )
+EXEC_OP( set_member_id_unplusplus )
+EXEC_OP( set_member_id_unminusminus )
+EXEC_OP( set_member_id_unplusplus_post )
+EXEC_OP( set_member_id_unminusminus_post )
+EXEC_OP( skipiftrue_else_consume )
+EXEC_OP( local_long_compare_jmpiffalse )
+EXEC_OP( local_local_compare_jmpiffalse )
+EXEC_OP( local_long_arith_assign )
+EXEC_OP( local_local_arith_assign )
+
+#undef EXEC_OP_YIELD
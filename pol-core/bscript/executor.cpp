@@ -29,12 +29,15 @@
 #include "execmodl.h"
 #include "fmodule.h"
 #include "impstr.h"
+#include "objmethods.h"
+#include "scriptsampler.h"
 #include "token.h"
 #include "tokens.h"
 #ifdef MEMORYLEAK
 #include "../clib/mlog.h"
 #endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -68,6 +71,223 @@ void display_executor_instances()
   }
 }
 
+namespace
+{
+// Arrays, structs and dictionaries are not copied when they get assigned to a variable or
+// passed as parameter. The variables share them until one of them modifies them or hands out an
+// element reference which might get written to, which has to unshare() first. Plain reads of
+// elements don't (see Executor::element_only_read).
+// Values stored inside of other containers are still copied, sharing could create cycles.
+bool is_shareable( const BObjectImp& imp )
+{
+  return imp.isa( BObjectImp::OTArray ) || imp.isa( BObjectImp::OTStruct ) ||
+         imp.isa( BObjectImp::OTDictionary );
+}
+
+// A foreach loop keeps its own reference to the container. The loop variable refers to the
+// elements of exactly that container, so it must neither be shared nor count as a sharer.
+unsigned int iterators( const BObjectImp& imp )
+{
+  switch ( imp.type() )
+  {
+  case BObjectImp::OTArray:
+    return static_cast<const ObjArray&>( imp ).iterators;
+  case BObjectImp::OTStruct:
+    return static_cast<const BStruct&>( imp ).iterators();
+  case BObjectImp::OTDictionary:
+    return static_cast<const BDictionary&>( imp ).iterators();
+  default:
+    return 0;
+  }
+}
+
+bool elements_escaped( const BObjectImp& imp )
+{
+  switch ( imp.type() )
+  {
+  case BObjectImp::OTArray:
+    return static_cast<const ObjArray&>( imp ).elements_escaped;
+  case BObjectImp::OTStruct:
+    return static_cast<const BStruct&>( imp ).elements_escaped();
+  case BObjectImp::OTDictionary:
+    return static_cast<const BDictionary&>( imp ).elements_escaped();
+  default:
+    return false;
+  }
+}
+
+void set_elements_escaped( BObjectImp& imp, bool escaped )
+{
+  switch ( imp.type() )
+  {
+  case BObjectImp::OTArray:
+    static_cast<ObjArray&>( imp ).elements_escaped = escaped;
+    break;
+  case BObjectImp::OTStruct:
+    static_cast<BStruct&>( imp ).set_elements_escaped( escaped );
+    break;
+  case BObjectImp::OTDictionary:
+    static_cast<BDictionary&>( imp ).set_elements_escaped( escaped );
+    break;
+  default:
+    break;
+  }
+}
+
+bool has_referenced_elements( BObjectImp& imp );
+
+// an element which is also referenced from outside of its container (byref parameter, foreach
+// variable, value stack), directly or by one of its own elements
+bool is_referenced( const BObjectRef& ref )
+{
+  return ref.get() != nullptr && ( ref->count() > 1 || has_referenced_elements( ref->impref() ) );
+}
+
+// Writes through such a reference would show up in every holder of a shared container.
+// Only containers which handed out element references since the last check get scanned (nested
+// ones are reached through their parent, which gets flagged as well), the flag is cleared once
+// none of the references is left.
+bool has_referenced_elements( BObjectImp& imp )
+{
+  if ( !elements_escaped( imp ) )
+    return false;
+  bool referenced = false;
+  switch ( imp.type() )
+  {
+  case BObjectImp::OTArray:
+    for ( const auto& ref : static_cast<ObjArray&>( imp ).ref_arr )
+    {
+      if ( is_referenced( ref ) )
+      {
+        referenced = true;
+        break;
+      }
+    }
+    break;
+  case BObjectImp::OTStruct:
+    for ( const auto& member : static_cast<BStruct&>( imp ).contents() )
+    {
+      if ( is_referenced( member.second ) )
+      {
+        referenced = true;
+        break;
+      }
+    }
+    break;
+  case BObjectImp::OTDictionary:
+    for ( const auto& entry : static_cast<BDictionary&>( imp ).contents() )
+    {
+      if ( is_referenced( entry.second ) )
+      {
+        referenced = true;
+        break;
+      }
+    }
+    break;
+  default:
+    break;
+  }
+  if ( !referenced )
+    set_elements_escaped( imp, false );
+  return referenced;
+}
+
+bool can_share( BObjectImp& imp )
+{
+  return is_shareable( imp ) && iterators( imp ) == 0 && !has_referenced_elements( imp );
+}
+
+// whether a new holder of the value of obj needs a copy of it
+bool needs_copy( const BObject& obj )
+{
+  return obj.count() != 1 || obj.impref().count() != 1;
+}
+
+BObjectImp* value_of( BObject& obj )
+{
+  return needs_copy( obj ) ? obj.impref().copy() : obj.impptr();
+}
+
+// value_of for a variable of its own, an alias (foreach variable, byref parameter) might refer to
+// an element of the container
+BObjectImp* value_for_variable( BObject& var, BObject& obj )
+{
+  if ( var.count() == 1 && can_share( obj.impref() ) )
+    return obj.impptr();
+  return value_of( obj );
+}
+
+BObjectImp* value_for_parameter( BObject& obj )
+{
+  BObjectImp& imp = obj.impref();
+  return can_share( imp ) ? &imp : imp.copy();
+}
+
+// gives obj its own copy of a shared container, before it gets modified or hands out an element
+// reference which might be written to
+void unshare( BObject& obj )
+{
+  BObjectImp& imp = obj.impref();
+  if ( is_shareable( imp ) && imp.count() > 1 + iterators( imp ) )
+    obj.setimp( imp.copy() );
+}
+
+// unshare() before an element reference gets handed out, which keeps obj from being shared as
+// long as the reference is around
+void unshare_for_element( BObject& obj )
+{
+  unshare( obj );
+  set_elements_escaped( obj.impref(), true );
+}
+
+// methods of arrays, structs and dictionaries which neither modify them nor return elements
+bool is_readonly_method( int id )
+{
+  return id == MTH_SIZE || id == MTH_EXISTS || id == MTH_KEYS;
+}
+
+// binary operators which neither modify their operands nor keep references to them
+bool is_reading_operator( BTokenId id )
+{
+  switch ( id )
+  {
+  case TOK_ADD:
+  case TOK_SUBTRACT:
+  case TOK_MULT:
+  case TOK_DIV:
+  case TOK_MODULUS:
+  case TOK_LESSTHAN:
+  case TOK_LESSEQ:
+  case TOK_GRTHAN:
+  case TOK_GREQ:
+  case TOK_EQUAL:
+  case TOK_NEQ:
+  case TOK_AND:
+  case TOK_OR:
+  case TOK_BITAND:
+  case TOK_BITOR:
+  case TOK_BITXOR:
+  case TOK_IN:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// instructions which only read the value on top of the stack, assigning it to a variable copies it
+bool reads_top( BTokenId id )
+{
+  return is_reading_operator( id ) || id == TOK_CONSUMER || id == RSV_JMPIFFALSE ||
+         id == RSV_JMPIFTRUE || id == INS_ASSIGN_LOCALVAR || id == INS_ASSIGN_GLOBALVAR;
+}
+
+bool is_push( BTokenId id )
+{
+  return id == TOK_LOCALVAR || id == TOK_GLOBALVAR || id == TOK_LONG || id == TOK_DOUBLE ||
+         id == TOK_STRING;
+}
+}  // namespace
+
 extern int executor_count;
 Clib::SpinLock Executor::_executor_lock;
 Executor::Executor()
@@ -115,6 +335,7 @@ Executor::~Executor()
     delete upperLocals2.back();
     upperLocals2.pop_back();
   }
+  Clib::delete_all( unusedLocals2_ );
 
   execmodules.clear();
   Clib::delete_all( availmodules );
@@ -776,6 +997,40 @@ bool Executor::setProgram( EScriptProgram* i_prog )
   return true;
 }
 
+void Executor::reset()
+{
+  ValueStack.clear();
+  fparams.clear();
+  Globals2.clear();
+  ControlStack.clear();
+  while ( !upperLocals2.empty() )
+    leave_frame();
+  if ( Locals2 )
+    Locals2->clear();
+  else
+    enter_frame();
+
+  execmodules.clear();
+  current_module_function = nullptr;
+  func_result_ = nullptr;
+  prog_.clear();
+  prog_ok_ = false;
+  nLines = 0;
+  PC = 0;
+  done = 0;
+  error_ = false;
+  halt_ = false;
+  run_ok_ = false;
+  viewmode_ = false;
+  runs_to_completion_ = false;
+  debug_level = NONE;
+  debugging_ = false;
+  debug_state_ = DEBUG_STATE_NONE;
+  breakpoints_.clear();
+  tmpbreakpoints_.clear();
+  bp_skip_ = ~0u;
+}
+
 BObjectRef Executor::getObjRef( void )
 {
   if ( ValueStack.empty() )
@@ -877,7 +1132,7 @@ void Executor::popParam( const Token& /*token*/ )
   BObjectRef objref = getObjRef();
 
   Locals2->push_back( BObjectRef() );
-  Locals2->back().set( new BObject( objref->impptr()->copy() ) );
+  Locals2->back().set( new BObject( value_for_parameter( *objref ) ) );
 }
 
 void Executor::popParamByRef( const Token& /*token*/ )
@@ -898,7 +1153,7 @@ void Executor::getArg( const Token& /*token*/ )
   {
     BObjectRef objref = getObjRef();
     Locals2->push_back( BObjectRef() );
-    Locals2->back().set( new BObject( objref->impptr()->copy() ) );
+    Locals2->back().set( new BObject( value_for_parameter( *objref ) ) );
   }
 }
 
@@ -962,6 +1217,7 @@ class ArrayIterator final : public ContIterator
 {
 public:
   ArrayIterator( ObjArray* pArr, BObject* pIterVal );
+  virtual ~ArrayIterator();
   virtual BObject* step() override;
 
 private:
@@ -980,6 +1236,11 @@ ArrayIterator::ArrayIterator( ObjArray* pArr, BObject* pIterVal )
       m_pIterVal( new BLong( 0 ) )
 {
   m_IterVal.get()->setimp( m_pIterVal );
+  ++m_pArray->iterators;
+}
+ArrayIterator::~ArrayIterator()
+{
+  --m_pArray->iterators;
 }
 BObject* ArrayIterator::step()
 {
@@ -1021,6 +1282,7 @@ void Executor::ins_initforeach( const Instruction& ins )
 
   // this is almost like popParam, only we don't want a copy.
   BObjectRef objref = getObjRef();
+  unshare( *objref );
   Locals2->push_back( BObjectRef() );
   Locals2->back().set( objref.get() );
 
@@ -1062,6 +1324,7 @@ void Executor::ins_initforeach2( const Instruction& ins )
 
   // this is almost like popParam, only we don't want a copy.
   BObjectRef objref = getObjRef();
+  unshare( *objref );
   Locals2->push_back( BObjectRef() );
   ContIterator* pIter = objref->impptr()->createIterator( pIterVal );
   Locals2->back().set( new BObject( pIter ) );
@@ -1317,9 +1580,8 @@ void Executor::ins_set_member( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  BObjectImp& rightimpref = right.impref();
-  left.impref().set_member( ins.token.tokval(), &rightimpref,
-                            !( right.count() == 1 && rightimpref.count() == 1 ) );
+  unshare( left );
+  left.impref().set_member( ins.token.tokval(), right.impptr(), needs_copy( right ) );
 }
 
 void Executor::ins_set_member_id( const Instruction& ins )
@@ -1331,9 +1593,8 @@ void Executor::ins_set_member_id( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  BObjectImp& rightimpref = right.impref();
-  left.impref().set_member_id( ins.token.lval, &rightimpref,
-                               !( right.count() == 1 && rightimpref.count() == 1 ) );
+  unshare( left );
+  left.impref().set_member_id( ins.token.lval, right.impptr(), needs_copy( right ) );
 }
 
 void Executor::ins_set_member_consume( const Instruction& ins )
@@ -1345,9 +1606,8 @@ void Executor::ins_set_member_consume( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  BObjectImp& rightimpref = right.impref();
-  left.impref().set_member( ins.token.tokval(), &rightimpref,
-                            !( right.count() == 1 && rightimpref.count() == 1 ) );
+  unshare( left );
+  left.impref().set_member( ins.token.tokval(), right.impptr(), needs_copy( right ) );
   ValueStack.pop_back();
 }
 
@@ -1360,10 +1620,8 @@ void Executor::ins_set_member_id_consume( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  BObjectImp& rightimpref = right.impref();
-
-  left.impref().set_member_id( ins.token.lval, &rightimpref,
-                               !( right.count() == 1 && rightimpref.count() == 1 ) );
+  unshare( left );
+  left.impref().set_member_id( ins.token.lval, right.impptr(), needs_copy( right ) );
   ValueStack.pop_back();
 }
 
@@ -1376,6 +1634,7 @@ void Executor::ins_set_member_id_consume_plusequal( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
   BObjectImp& leftimpref = left.impref();
 
   BObjectRef tmp = leftimpref.get_member_id( ins.token.lval );
@@ -1398,6 +1657,7 @@ void Executor::ins_set_member_id_consume_minusequal( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
   BObjectImp& leftimpref = left.impref();
 
   BObjectRef tmp = leftimpref.get_member_id( ins.token.lval );
@@ -1420,6 +1680,7 @@ void Executor::ins_set_member_id_consume_timesequal( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
   BObjectImp& leftimpref = left.impref();
 
   BObjectRef tmp = leftimpref.get_member_id( ins.token.lval );
@@ -1442,6 +1703,7 @@ void Executor::ins_set_member_id_consume_divideequal( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
   BObjectImp& leftimpref = left.impref();
 
   BObjectRef tmp = leftimpref.get_member_id( ins.token.lval );
@@ -1464,6 +1726,7 @@ void Executor::ins_set_member_id_consume_modulusequal( const Instruction& ins )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
   BObjectImp& leftimpref = left.impref();
 
   BObjectRef tmp = leftimpref.get_member_id( ins.token.lval );
@@ -1482,6 +1745,8 @@ void Executor::ins_get_member( const Instruction& ins )
   BObjectRef& leftref = ValueStack.back();
 
   BObject& left = *leftref;
+  if ( !element_only_read( PC ) )
+    unshare_for_element( left );
 
 #ifdef ESCRIPT_PROFILE
   std::stringstream strm;
@@ -1502,6 +1767,8 @@ void Executor::ins_get_member_id( const Instruction& ins )
   BObjectRef& leftref = ValueStack.back();
 
   BObject& left = *leftref;
+  if ( !element_only_read( PC ) )
+    unshare_for_element( left );
 
 #ifdef ESCRIPT_PROFILE
   std::stringstream strm;
@@ -1511,7 +1778,7 @@ void Executor::ins_get_member_id( const Instruction& ins )
   std::string name( strm.str() );
   unsigned long profile_start = GetTimeUs();
 #endif
-  leftref = left->get_member_id( ins.token.lval );
+  leftref = left->get_member_id_cached( ins.token.lval, ins.cache );
 #ifdef ESCRIPT_PROFILE
   profile_escript( name, profile_start );
 #endif
@@ -1525,16 +1792,7 @@ void Executor::ins_assign_localvar( const Instruction& ins )
 
   BObject& right = *rightref;
 
-  BObjectImp& rightimpref = right.impref();
-
-  if ( right.count() == 1 && rightimpref.count() == 1 )
-  {
-    lvar->setimp( &rightimpref );
-  }
-  else
-  {
-    lvar->setimp( rightimpref.copy() );
-  }
+  lvar->setimp( value_for_variable( *lvar, right ) );
   ValueStack.pop_back();
 }
 void Executor::ins_assign_globalvar( const Instruction& ins )
@@ -1545,16 +1803,7 @@ void Executor::ins_assign_globalvar( const Instruction& ins )
 
   BObject& right = *rightref;
 
-  BObjectImp& rightimpref = right.impref();
-
-  if ( right.count() == 1 && rightimpref.count() == 1 )
-  {
-    gvar->setimp( &rightimpref );
-  }
-  else
-  {
-    gvar->setimp( rightimpref.copy() );
-  }
+  gvar->setimp( value_for_variable( *gvar, right ) );
   ValueStack.pop_back();
 }
 
@@ -1568,16 +1817,7 @@ void Executor::ins_assign_consume( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  BObjectImp& rightimpref = right.impref();
-
-  if ( right.count() == 1 && rightimpref.count() == 1 )
-  {
-    left.setimp( &rightimpref );
-  }
-  else
-  {
-    left.setimp( rightimpref.copy() );
-  }
+  left.setimp( value_of( right ) );
   ValueStack.pop_back();
 }
 
@@ -1595,16 +1835,7 @@ void Executor::ins_assign( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
-  BObjectImp& rightimpref = right.impref();
-
-  if ( right.count() == 1 && rightimpref.count() == 1 )
-  {
-    left.setimp( &rightimpref );
-  }
-  else
-  {
-    left.setimp( rightimpref.copy() );
-  }
+  left.setimp( value_of( right ) );
 }
 
 void Executor::ins_array_assign( const Instruction& /*ins*/ )
@@ -1630,6 +1861,7 @@ void Executor::ins_array_assign( const Instruction& /*ins*/ )
   BObject& x = *x_ref;
 
   BObjectImp* result;
+  unshare( x );
   result = x->array_assign( i.impptr(), y.impptr(), ( y.count() != 1 ) );
 
   x_ref.set( new BObject( result ) );
@@ -1657,12 +1889,127 @@ void Executor::ins_array_assign_consume( const Instruction& /*ins*/ )
   BObject& x = *x_ref;
 
   BObjectImp* result;
+  unshare( x );
   result = x->array_assign( i.impptr(), y.impptr(), ( y.count() != 1 ) );
 
   BObject obj( result );
   ValueStack.pop_back();
 }
 
+namespace
+{
+// A value on the stack nobody else refers to: literals and the results of operators and function
+// calls. Variables, members and elements are pushed by reference and are never temporaries.
+inline bool is_temporary( const BObjectRef& ref )
+{
+  return ref->count() == 1 && ref->impref().count() == 1;
+}
+
+// Stores the result of a binary operator in leftref. If one of the operands is a temporary of the
+// result type its value gets overwritten in place, so e.g. "i + 1" or "i < 10" reuse the literal
+// instead of allocating a new BObject and BLong.
+template <class Imp, class T>
+void set_scalar_result( BObjectRef& leftref, BObjectRef& rightref, BObjectImp::BObjectType type,
+                        T value )
+{
+  if ( leftref->isa( type ) && is_temporary( leftref ) )
+  {
+    static_cast<Imp&>( leftref->impref() ).setvalue( value );
+  }
+  else if ( rightref->isa( type ) && is_temporary( rightref ) )
+  {
+    static_cast<Imp&>( rightref->impref() ).setvalue( value );
+    leftref = rightref;
+  }
+  else if ( leftref->count() == 1 )
+  {
+    leftref->setimp( new Imp( value ) );
+  }
+  else
+  {
+    leftref.set( new BObject( new Imp( value ) ) );
+  }
+}
+
+inline void set_long_result( BObjectRef& leftref, BObjectRef& rightref, int value )
+{
+  set_scalar_result<BLong>( leftref, rightref, BObjectImp::OTLong, value );
+}
+
+inline void set_double_result( BObjectRef& leftref, BObjectRef& rightref, double value )
+{
+  set_scalar_result<Double>( leftref, rightref, BObjectImp::OTDouble, value );
+}
+
+// Integer and real arithmetic without the double dispatch through BObjectImp, same result types
+// as BLong/Double. Returns false for all other operand types.
+template <class Op>
+bool scalar_arith( BObjectRef& leftref, BObjectRef& rightref, Op op )
+{
+  const BObjectImp& left = leftref->impref();
+  const BObjectImp& right = rightref->impref();
+  if ( left.isa( BObjectImp::OTLong ) )
+  {
+    int lval = static_cast<const BLong&>( left ).value();
+    if ( right.isa( BObjectImp::OTLong ) )
+    {
+      set_long_result( leftref, rightref, op( lval, static_cast<const BLong&>( right ).value() ) );
+      return true;
+    }
+    if ( right.isa( BObjectImp::OTDouble ) )
+    {
+      set_double_result( leftref, rightref,
+                         op( static_cast<double>( lval ),
+                             static_cast<const Double&>( right ).value() ) );
+      return true;
+    }
+  }
+  else if ( left.isa( BObjectImp::OTDouble ) )
+  {
+    double dval = static_cast<const Double&>( left ).value();
+    if ( right.isa( BObjectImp::OTLong ) )
+    {
+      set_double_result( leftref, rightref,
+                         op( dval, static_cast<double>(
+                                       static_cast<const BLong&>( right ).value() ) ) );
+      return true;
+    }
+    if ( right.isa( BObjectImp::OTDouble ) )
+    {
+      set_double_result( leftref, rightref,
+                         op( dval, static_cast<const Double&>( right ).value() ) );
+      return true;
+    }
+  }
+  return false;
+}
+
+struct ScalarPlus
+{
+  template <class T>
+  T operator()( T a, T b ) const
+  {
+    return a + b;
+  }
+};
+struct ScalarMinus
+{
+  template <class T>
+  T operator()( T a, T b ) const
+  {
+    return a - b;
+  }
+};
+struct ScalarTimes
+{
+  template <class T>
+  T operator()( T a, T b ) const
+  {
+    return a * b;
+  }
+};
+}  // namespace
+
 // TOK_ADD:
 void Executor::ins_add( const Instruction& /*ins*/ )
 {
@@ -1675,6 +2022,9 @@ void Executor::ins_add( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
+  if ( scalar_arith( leftref, rightref, ScalarPlus() ) )
+    return;
+
   BObject& right = *rightref;
   BObject& left = *leftref;
 
@@ -1693,6 +2043,9 @@ void Executor::ins_subtract( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
+  if ( scalar_arith( leftref, rightref, ScalarMinus() ) )
+    return;
+
   BObject& right = *rightref;
   BObject& left = *leftref;
 
@@ -1711,6 +2064,9 @@ void Executor::ins_mult( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
+  if ( scalar_arith( leftref, rightref, ScalarTimes() ) )
+    return;
+
   BObject& right = *rightref;
   BObject& left = *leftref;
 
@@ -1851,7 +2207,7 @@ void Executor::ins_logical_and( const Instruction& /*ins*/ )
   BObject& left = *leftref;
 
   int _true = ( left.isTrue() && right.isTrue() );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  set_long_result( leftref, rightref, _true );
 }
 void Executor::ins_logical_or( const Instruction& /*ins*/ )
 {
@@ -1868,7 +2224,7 @@ void Executor::ins_logical_or( const Instruction& /*ins*/ )
   BObject& left = *leftref;
 
   int _true = ( left.isTrue() || right.isTrue() );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  set_long_result( leftref, rightref, _true );
 }
 
 void Executor::ins_notequal( const Instruction& /*ins*/ )
@@ -1886,7 +2242,7 @@ void Executor::ins_notequal( const Instruction& /*ins*/ )
   BObject& left = *leftref;
 
   int _true = ( left != right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  set_long_result( leftref, rightref, _true );
 }
 
 void Executor::ins_equal( const Instruction& /*ins*/ )
@@ -1904,7 +2260,7 @@ void Executor::ins_equal( const Instruction& /*ins*/ )
   BObject& left = *leftref;
 
   int _true = ( left == right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  set_long_result( leftref, rightref, _true );
 }
 
 void Executor::ins_lessthan( const Instruction& /*ins*/ )
@@ -1922,7 +2278,7 @@ void Executor::ins_lessthan( const Instruction& /*ins*/ )
   BObject& left = *leftref;
 
   int _true = ( left < right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  set_long_result( leftref, rightref, _true );
 }
 
 void Executor::ins_lessequal( const Instruction& /*ins*/ )
@@ -1939,7 +2295,7 @@ void Executor::ins_lessequal( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
   int _true = ( left <= right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  set_long_result( leftref, rightref, _true );
 }
 void Executor::ins_greaterthan( const Instruction& /*ins*/ )
 {
@@ -1956,7 +2312,7 @@ void Executor::ins_greaterthan( const Instruction& /*ins*/ )
   BObject& left = *leftref;
 
   int _true = ( left > right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  set_long_result( leftref, rightref, _true );
 }
 void Executor::ins_greaterequal( const Instruction& /*ins*/ )
 {
@@ -1973,7 +2329,7 @@ void Executor::ins_greaterequal( const Instruction& /*ins*/ )
   BObject& left = *leftref;
 
   int _true = ( left >= right );
-  leftref.set( new BObject( new BLong( _true ) ) );
+  set_long_result( leftref, rightref, _true );
 }
 
 // case TOK_ARRAY_SUBSCRIPT:
@@ -1988,6 +2344,9 @@ void Executor::ins_arraysubscript( const Instruction& /*ins*/ )
   ValueStack.pop_back();
   BObjectRef& leftref = ValueStack.back();
 
+  if ( !element_only_read( PC ) )
+    unshare_for_element( *leftref );
+
   leftref = ( *leftref )->OperSubscript( *rightref );
 }
 
@@ -2002,6 +2361,8 @@ void Executor::ins_multisubscript( const Instruction& ins )
   }
 
   BObjectRef& leftref = ValueStack.back();
+  if ( !element_only_read( PC ) )
+    unshare_for_element( *leftref );
   leftref = ( *leftref )->OperMultiSubscript( indices );
 }
 void Executor::ins_multisubscript_assign( const Instruction& ins )
@@ -2017,6 +2378,7 @@ void Executor::ins_multisubscript_assign( const Instruction& ins )
   }
 
   BObjectRef& leftref = ValueStack.back();
+  unshare_for_element( *leftref );
   leftref = ( *leftref )->OperMultiSubscriptAssign( indices, target_ref->impptr() );
 }
 
@@ -2033,6 +2395,7 @@ void Executor::ins_addmember( const Instruction& /*ins*/ )
 
   BObject& right = *rightref;
   BObject& left = *leftref;
+  unshare( left );
 
   leftref = addmember( left, right );
 }
@@ -2050,6 +2413,7 @@ void Executor::ins_removemember( const Instruction& /*ins*/ )
 
   BObject& right = *rightref;
   BObject& left = *leftref;
+  unshare( left );
 
   leftref = removemember( left, right );
 }
@@ -2076,6 +2440,7 @@ void Executor::ins_addmember2( const Instruction& ins )
   BObjectRef obref = ValueStack.back();
 
   BObject& ob = *obref;
+  unshare( ob );
 
   ob.impref().operDotPlus( ins.token.tokval() );
 }
@@ -2084,24 +2449,17 @@ void Executor::ins_addmember_assign( const Instruction& ins )
 {
   BObjectRef valref = ValueStack.back();
   BObject& valob = *valref;
-  BObjectImp* valimp = valref->impptr();
 
   ValueStack.pop_back();
 
   BObjectRef obref = ValueStack.back();
   BObject& ob = *obref;
+  unshare( ob );
 
   BObjectRef memref = ob.impref().operDotPlus( ins.token.tokval() );
   BObject& mem = *memref;
 
-  if ( valob.count() == 1 && valimp->count() == 1 )
-  {
-    mem.setimp( valimp );
-  }
-  else
-  {
-    mem.setimp( valimp->copy() );
-  }
+  mem.setimp( value_of( valob ) );
   // the struct is at the top of the stack
 }
 
@@ -2136,7 +2494,7 @@ void Executor::ins_dictionary_addmember( const Instruction& /*ins*/ )
   {
     keyimp = keyimp->copy();
   }
-  if ( valob.count() != 1 || valimp->count() != 1 )
+  if ( needs_copy( valob ) )
   {
     valimp = valimp->copy();
   }
@@ -2170,6 +2528,7 @@ void Executor::ins_insert_into( const Instruction& /*ins*/ )
 
   BObject& right = *rightref;
   BObject& left = *leftref;
+  unshare( left );
 
   left.impref().operInsertInto( left, right.impref() );
 }
@@ -2188,6 +2547,8 @@ void Executor::ins_plusequal( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
+
   left.impref().operPlusEqual( left, right.impref() );
 }
 
@@ -2205,6 +2566,8 @@ void Executor::ins_minusequal( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
+
   left.impref().operMinusEqual( left, right.impref() );
 }
 
@@ -2222,6 +2585,8 @@ void Executor::ins_timesequal( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
+
   left.impref().operTimesEqual( left, right.impref() );
 }
 
@@ -2239,6 +2604,8 @@ void Executor::ins_divideequal( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
+
   left.impref().operDivideEqual( left, right.impref() );
 }
 
@@ -2256,6 +2623,8 @@ void Executor::ins_modulusequal( const Instruction& /*ins*/ )
   BObject& right = *rightref;
   BObject& left = *leftref;
 
+  unshare( left );
+
   left.impref().operModulusEqual( left, right.impref() );
 }
 
@@ -2300,6 +2669,8 @@ void Executor::ins_call_method_id( const Instruction& ins )
     }
   }
   BObjectRef& objref = ValueStack.back();
+  if ( !is_readonly_method( ins.token.lval ) )
+    unshare( *objref );
 #ifdef ESCRIPT_PROFILE
   std::stringstream strm;
   strm << "MTHID_" << objref->impptr()->typeOf() << " ." << ins.token.lval;
@@ -2361,6 +2732,7 @@ void Executor::ins_call_method( const Instruction& ins )
   }
 
   BObjectRef& objref = ValueStack.back();
+  unshare( *objref );
 #ifdef ESCRIPT_PROFILE
   std::stringstream strm;
   strm << "MTH_" << objref->impptr()->typeOf() << " ." << ins.token.tokval();
@@ -2415,10 +2787,43 @@ void Executor::ins_progend( const Instruction& /*ins*/ )
 
 // case CTRL_MAKELOCAL:
 void Executor::ins_makelocal( const Instruction& /*ins*/ )
+{
+  enter_frame();
+}
+
+void Executor::enter_frame()
 {
   if ( Locals2 )
     upperLocals2.push_back( Locals2 );
-  Locals2 = new BObjectRefVec;
+  if ( unusedLocals2_.empty() )
+  {
+    Locals2 = new BObjectRefVec;
+  }
+  else
+  {
+    Locals2 = unusedLocals2_.back();
+    unusedLocals2_.pop_back();
+  }
+}
+
+void Executor::leave_frame()
+{
+  if ( Locals2 )
+  {
+    if ( unusedLocals2_.size() < MAX_UNUSED_FRAMES )
+    {
+      Locals2->clear();
+      unusedLocals2_.push_back( Locals2 );
+    }
+    else
+      delete Locals2;
+    Locals2 = nullptr;
+  }
+  if ( !upperLocals2.empty() )
+  {
+    Locals2 = upperLocals2.back();
+    upperLocals2.pop_back();
+  }
 }
 
 // CTRL_JSR_USERFUNC:
@@ -2482,9 +2887,7 @@ void Executor::ins_gosub( const Instruction& ins )
   rc.PC = PC;
   rc.ValueStackDepth = static_cast<unsigned int>( ValueStack.size() );
   ControlStack.push_back( rc );
-  if ( Locals2 )
-    upperLocals2.push_back( Locals2 );
-  Locals2 = new BObjectRefVec;
+  enter_frame();
 
   PC = (unsigned)ins.token.lval;
 }
@@ -2504,16 +2907,7 @@ void Executor::ins_return( const Instruction& /*ins*/ )
   // FIXME do something with rc.ValueStackDepth
   ControlStack.pop_back();
 
-  if ( Locals2 )
-  {
-    delete Locals2;
-    Locals2 = nullptr;
-  }
-  if ( !upperLocals2.empty() )
-  {
-    Locals2 = upperLocals2.back();
-    upperLocals2.pop_back();
-  }
+  leave_frame();
 }
 
 void Executor::ins_exit( const Instruction& /*ins*/ )
@@ -2528,7 +2922,8 @@ void Executor::ins_double( const Instruction& ins )
 }
 void Executor::ins_string( const Instruction& ins )
 {
-  ValueStack.push_back( BObjectRef( new BObject( new String( ins.token.tokval() ) ) ) );
+  ValueStack.push_back(
+      BObjectRef( new BObject( new String( prog_->string_literals[ins.token.lval] ) ) ) );
 }
 void Executor::ins_error( const Instruction& /*ins*/ )
 {
@@ -2559,6 +2954,24 @@ void Executor::ins_ident( const Instruction& /*ins*/ )
 void Executor::ins_unminus( const Instruction& /*ins*/ )
 {
   BObjectRef ref = getObjRef();
+  if ( is_temporary( ref ) )
+  {
+    BObjectImp& imp = ref->impref();
+    if ( imp.isa( BObjectImp::OTLong ) )
+    {
+      BLong& blong = static_cast<BLong&>( imp );
+      blong.setvalue( -blong.value() );
+      ValueStack.push_back( ref );
+      return;
+    }
+    if ( imp.isa( BObjectImp::OTDouble ) )
+    {
+      Double& dbl = static_cast<Double&>( imp );
+      dbl.setvalue( -dbl.value() );
+      ValueStack.push_back( ref );
+      return;
+    }
+  }
   BObjectImp* newobj;
   newobj = ref->impref().inverse();
 
@@ -2603,6 +3016,7 @@ void Executor::ins_unminusminus_post( const Instruction& /*ins*/ )
 void Executor::ins_set_member_id_unplusplus( const Instruction& ins )
 {
   BObjectRef ref = ValueStack.back();
+  unshare( *ref );
   BObjectRef tmp = ref->impref().get_member_id( ins.token.lval );
   if ( !tmp->isa( BObjectImp::OTUninit ) &&
        !tmp->isa( BObjectImp::OTError ) )  // do nothing if curval is uninit or error
@@ -2617,6 +3031,7 @@ void Executor::ins_set_member_id_unplusplus( const Instruction& ins )
 void Executor::ins_set_member_id_unplusplus_post( const Instruction& ins )
 {
   BObjectRef ref = ValueStack.back();
+  unshare( *ref );
   BObjectRef tmp = ref->impref().get_member_id( ins.token.lval );
   BObject* res = tmp->clone();
   if ( !tmp->isa( BObjectImp::OTUninit ) &&
@@ -2632,6 +3047,7 @@ void Executor::ins_set_member_id_unplusplus_post( const Instruction& ins )
 void Executor::ins_set_member_id_unminusminus( const Instruction& ins )
 {
   BObjectRef ref = ValueStack.back();
+  unshare( *ref );
   BObjectRef tmp = ref->impref().get_member_id( ins.token.lval );
   if ( !tmp->isa( BObjectImp::OTUninit ) &&
        !tmp->isa( BObjectImp::OTError ) )  // do nothing if curval is uninit or error
@@ -2646,6 +3062,7 @@ void Executor::ins_set_member_id_unminusminus( const Instruction& ins )
 void Executor::ins_set_member_id_unminusminus_post( const Instruction& ins )
 {
   BObjectRef ref = ValueStack.back();
+  unshare( *ref );
   BObjectRef tmp = ref->impref().get_member_id( ins.token.lval );
   BObject* res = tmp->clone();
   if ( !tmp->isa( BObjectImp::OTUninit ) &&
@@ -2661,7 +3078,16 @@ void Executor::ins_set_member_id_unminusminus_post( const Instruction& ins )
 void Executor::ins_logical_not( const Instruction& /*ins*/ )
 {
   BObjectRef ref = getObjRef();
-  ValueStack.push_back( BObjectRef( new BObject( new BLong( (int)!ref->impptr()->isTrue() ) ) ) );
+  int _true = !ref->impptr()->isTrue();
+  if ( ref->isa( BObjectImp::OTLong ) && is_temporary( ref ) )
+  {
+    static_cast<BLong&>( ref->impref() ).setvalue( _true );
+    ValueStack.push_back( ref );
+  }
+  else
+  {
+    ValueStack.push_back( BObjectRef( new BObject( new BLong( _true ) ) ) );
+  }
 }
 
 // case TOK_BITWISE_NOT:
@@ -2680,226 +3106,405 @@ void Executor::ins_funcref( const Instruction& ins )
 
 void Executor::ins_nop( const Instruction& /*ins*/ ) {}
 
-ExecInstrFunc Executor::GetInstrFunc( const Token& token )
+namespace
+{
+bool compare_longs( BTokenId op, int lhs, int rhs )
+{
+  switch ( op )
+  {
+  case TOK_LESSTHAN:
+    return lhs < rhs;
+  case TOK_LESSEQ:
+    return lhs <= rhs;
+  case TOK_GRTHAN:
+    return lhs > rhs;
+  case TOK_GREQ:
+    return lhs >= rhs;
+  case TOK_EQUAL:
+    return lhs == rhs;
+  default:  // TOK_NEQ
+    return lhs != rhs;
+  }
+}
+
+int calc_longs( BTokenId op, int lhs, int rhs )
+{
+  switch ( op )
+  {
+  case TOK_ADD:
+    return lhs + rhs;
+  case TOK_SUBTRACT:
+    return lhs - rhs;
+  default:  // TOK_MULT
+    return lhs * rhs;
+  }
+}
+}  // namespace
+
+// A superinstruction replaces the first instruction of its sequence, the following instructions
+// are still in the program: PC points to the second one. If the operands are no integers (or a
+// debugger steps through the script) it behaves like the TOK_LOCALVAR it replaced, and the
+// rest of the sequence runs instruction by instruction.
+bool Executor::superinstruction_operands( const Instruction& ins, bool rhs_is_local, int& lhs,
+                                          int& rhs ) const
+{
+  if ( debugging_ )
+    return false;
+  const BObjectImp* left = ( *Locals2 )[ins.token.lval]->impptr();
+  if ( !left->isa( BObjectImp::OTLong ) )
+    return false;
+  lhs = static_cast<const BLong*>( left )->value();
+
+  const Token& rhs_token = prog_->instr[PC].token;
+  if ( rhs_is_local )
+  {
+    const BObjectImp* right = ( *Locals2 )[rhs_token.lval]->impptr();
+    if ( !right->isa( BObjectImp::OTLong ) )
+      return false;
+    rhs = static_cast<const BLong*>( right )->value();
+  }
+  else
+  {
+    rhs = rhs_token.lval;
+  }
+  return true;
+}
+
+// Whether the element an access instruction is about to push gets only read by the instructions
+// starting at pos, e.g. "x := a[i]", "a[i] == 5" or "a[i].x". Then its container doesn't need to be
+// unshared. Anything else (compound assignment, byref parameter, method call) might write through
+// the reference.
+bool Executor::element_only_read( unsigned pos ) const
+{
+  if ( pos >= nLines )
+    return false;
+  BTokenId next = prog_->instr[pos].token.id;
+  if ( reads_top( next ) )
+    return true;
+  if ( next == INS_GET_MEMBER || next == INS_GET_MEMBER_ID )
+    return element_only_read( pos + 1 );
+  if ( !is_push( next ) || pos + 1 >= nLines )
+    return false;
+  // the element is the left operand of an operator or gets subscripted by a single index
+  BTokenId second = prog_->instr[pos + 1].token.id;
+  if ( second == TOK_ARRAY_SUBSCRIPT )
+    return element_only_read( pos + 2 );
+  return is_reading_operator( second );
+}
+
+void Executor::assign_local_long( unsigned varnum, int value )
+{
+  BObject& lvar = *( *Locals2 )[varnum];
+  BObjectImp& imp = lvar.impref();
+  if ( imp.isa( BObjectImp::OTLong ) && imp.count() == 1 )
+    static_cast<BLong&>( imp ).setvalue( value );
+  else
+    lvar.setimp( new BLong( value ) );
+}
+
+// localvar, long, <comparison>, jmpiffalse
+void Executor::ins_local_long_compare_jmpiffalse( const Instruction& ins )
+{
+  int lhs, rhs;
+  if ( !superinstruction_operands( ins, false, lhs, rhs ) )
+  {
+    ins_localvar( ins );
+    return;
+  }
+  const Instruction* seq = &prog_->instr[PC];
+  if ( compare_longs( seq[1].token.id, lhs, rhs ) )
+    PC += 3;
+  else
+    PC = seq[2].token.lval;
+}
+
+// localvar, localvar, <comparison>, jmpiffalse
+void Executor::ins_local_local_compare_jmpiffalse( const Instruction& ins )
+{
+  int lhs, rhs;
+  if ( !superinstruction_operands( ins, true, lhs, rhs ) )
+  {
+    ins_localvar( ins );
+    return;
+  }
+  const Instruction* seq = &prog_->instr[PC];
+  if ( compare_longs( seq[1].token.id, lhs, rhs ) )
+    PC += 3;
+  else
+    PC = seq[2].token.lval;
+}
+
+// localvar, long, + - *, assign localvar
+void Executor::ins_local_long_arith_assign( const Instruction& ins )
+{
+  int lhs, rhs;
+  if ( !superinstruction_operands( ins, false, lhs, rhs ) )
+  {
+    ins_localvar( ins );
+    return;
+  }
+  const Instruction* seq = &prog_->instr[PC];
+  assign_local_long( seq[2].token.lval, calc_longs( seq[1].token.id, lhs, rhs ) );
+  PC += 3;
+}
+
+// localvar, localvar, + - *, assign localvar
+void Executor::ins_local_local_arith_assign( const Instruction& ins )
+{
+  int lhs, rhs;
+  if ( !superinstruction_operands( ins, true, lhs, rhs ) )
+  {
+    ins_localvar( ins );
+    return;
+  }
+  const Instruction* seq = &prog_->instr[PC];
+  assign_local_long( seq[2].token.lval, calc_longs( seq[1].token.id, lhs, rhs ) );
+  PC += 3;
+}
+
+Executor::Opcode Executor::GetInstrOpcode( const Token& token )
 {
   switch ( token.id )
   {
   case INS_INITFOREACH:
-    return &Executor::ins_initforeach2;
+    return OP_initforeach2;
   case INS_STEPFOREACH:
-    return &Executor::ins_stepforeach2;
+    return OP_stepforeach2;
   case INS_INITFOR:
-    return &Executor::ins_initfor;
+    return OP_initfor;
   case INS_NEXTFOR:
-    return &Executor::ins_nextfor;
+    return OP_nextfor;
   case INS_CASEJMP:
-    return &Executor::ins_casejmp;
+    return OP_casejmp;
   case RSV_JMPIFTRUE:
-    return &Executor::ins_jmpiftrue;
+    return OP_jmpiftrue;
   case RSV_JMPIFFALSE:
-    return &Executor::ins_jmpiffalse;
+    return OP_jmpiffalse;
   case RSV_LOCAL:
-    return &Executor::ins_makeLocal;
+    return OP_makeLocal;
   case RSV_GLOBAL:
   case TOK_GLOBALVAR:
-    return &Executor::ins_globalvar;
+    return OP_globalvar;
   case TOK_LOCALVAR:
-    return &Executor::ins_localvar;
+    return OP_localvar;
   case TOK_LONG:
-    return &Executor::ins_long;
+    return OP_long;
   case TOK_DOUBLE:
-    return &Executor::ins_double;
+    return OP_double;
   case TOK_STRING:
-    return &Executor::ins_string;
+    return OP_string;
   case TOK_ERROR:
-    return &Executor::ins_error;
+    return OP_error;
   case TOK_STRUCT:
-    return &Executor::ins_struct;
+    return OP_struct;
   case TOK_ARRAY:
-    return &Executor::ins_array;
+    return OP_array;
   case TOK_DICTIONARY:
-    return &Executor::ins_dictionary;
+    return OP_dictionary;
   case TOK_FUNCREF:
-    return &Executor::ins_funcref;
+    return OP_funcref;
   case INS_UNINIT:
-    return &Executor::ins_uninit;
+    return OP_uninit;
   case TOK_IDENT:
-    return &Executor::ins_ident;
+    return OP_ident;
   case INS_ASSIGN_GLOBALVAR:
-    return &Executor::ins_assign_globalvar;
+    return OP_assign_globalvar;
   case INS_ASSIGN_LOCALVAR:
-    return &Executor::ins_assign_localvar;
+    return OP_assign_localvar;
   case INS_ASSIGN_CONSUME:
-    return &Executor::ins_assign_consume;
+    return OP_assign_consume;
   case TOK_CONSUMER:
-    return &Executor::ins_consume;
+    return OP_consume;
   case TOK_ASSIGN:
-    return &Executor::ins_assign;
+    return OP_assign;
   case INS_SUBSCRIPT_ASSIGN:
-    return &Executor::ins_array_assign;
+    return OP_array_assign;
   case INS_SUBSCRIPT_ASSIGN_CONSUME:
-    return &Executor::ins_array_assign_consume;
+    return OP_array_assign_consume;
   case INS_MULTISUBSCRIPT:
-    return &Executor::ins_multisubscript;
+    return OP_multisubscript;
   case INS_MULTISUBSCRIPT_ASSIGN:
-    return &Executor::ins_multisubscript_assign;
+    return OP_multisubscript_assign;
   case INS_GET_MEMBER:
-    return &Executor::ins_get_member;
+    return OP_get_member;
   case INS_SET_MEMBER:
-    return &Executor::ins_set_member;
+    return OP_set_member;
   case INS_SET_MEMBER_CONSUME:
-    return &Executor::ins_set_member_consume;
+    return OP_set_member_consume;
 
   case INS_GET_MEMBER_ID:
-    return &Executor::ins_get_member_id;  // test id
+    return OP_get_member_id;  // test id
   case INS_SET_MEMBER_ID:
-    return &Executor::ins_set_member_id;  // test id
+    return OP_set_member_id;  // test id
   case INS_SET_MEMBER_ID_CONSUME:
-    return &Executor::ins_set_member_id_consume;  // test id
+    return OP_set_member_id_consume;  // test id
 
   case INS_SET_MEMBER_ID_CONSUME_PLUSEQUAL:
-    return &Executor::ins_set_member_id_consume_plusequal;  // test id
+    return OP_set_member_id_consume_plusequal;  // test id
   case INS_SET_MEMBER_ID_CONSUME_MINUSEQUAL:
-    return &Executor::ins_set_member_id_consume_minusequal;  // test id
+    return OP_set_member_id_consume_minusequal;  // test id
   case INS_SET_MEMBER_ID_CONSUME_TIMESEQUAL:
-    return &Executor::ins_set_member_id_consume_timesequal;  // test id
+    return OP_set_member_id_consume_timesequal;  // test id
   case INS_SET_MEMBER_ID_CONSUME_DIVIDEEQUAL:
-    return &Executor::ins_set_member_id_consume_divideequal;  // test id
+    return OP_set_member_id_consume_divideequal;  // test id
   case INS_SET_MEMBER_ID_CONSUME_MODULUSEQUAL:
-    return &Executor::ins_set_member_id_consume_modulusequal;  // test id
+    return OP_set_member_id_consume_modulusequal;  // test id
 
   case TOK_ADD:
-    return &Executor::ins_add;
+    return OP_add;
   case TOK_SUBTRACT:
-    return &Executor::ins_subtract;
+    return OP_subtract;
   case TOK_DIV:
-    return &Executor::ins_div;
+    return OP_div;
   case TOK_MULT:
-    return &Executor::ins_mult;
+    return OP_mult;
   case TOK_MODULUS:
-    return &Executor::ins_modulus;
+    return OP_modulus;
 
   case TOK_INSERTINTO:
-    return &Executor::ins_insert_into;
+    return OP_insert_into;
 
   case TOK_PLUSEQUAL:
-    return &Executor::ins_plusequal;
+    return OP_plusequal;
   case TOK_MINUSEQUAL:
-    return &Executor::ins_minusequal;
+    return OP_minusequal;
   case TOK_TIMESEQUAL:
-    return &Executor::ins_timesequal;
+    return OP_timesequal;
   case TOK_DIVIDEEQUAL:
-    return &Executor::ins_divideequal;
+    return OP_divideequal;
   case TOK_MODULUSEQUAL:
-    return &Executor::ins_modulusequal;
+    return OP_modulusequal;
 
   case TOK_LESSTHAN:
-    return &Executor::ins_lessthan;
+    return OP_lessthan;
   case TOK_LESSEQ:
-    return &Executor::ins_lessequal;
+    return OP_lessequal;
   case RSV_GOTO:
-    return &Executor::ins_goto;
+    return OP_goto;
   case TOK_ARRAY_SUBSCRIPT:
-    return &Executor::ins_arraysubscript;
+    return OP_arraysubscript;
   case TOK_EQUAL:
-    return &Executor::ins_equal;
+    return OP_equal;
   case TOK_FUNC:
-    return &Executor::ins_func;
+    return OP_func;
   case INS_CALL_METHOD:
-    return &Executor::ins_call_method;
+    return OP_call_method;
   case INS_CALL_METHOD_ID:
-    return &Executor::ins_call_method_id;
+    return OP_call_method_id;
   case CTRL_STATEMENTBEGIN:
-    return &Executor::ins_statementbegin;
+    return OP_statementbegin;
   case CTRL_MAKELOCAL:
-    return &Executor::ins_makelocal;
+    return OP_makelocal;
   case CTRL_JSR_USERFUNC:
-    return &Executor::ins_jsr_userfunc;
+    return OP_jsr_userfunc;
   case INS_POP_PARAM:
-    return &Executor::ins_pop_param;
+    return OP_pop_param;
   case INS_POP_PARAM_BYREF:
-    return &Executor::ins_pop_param_byref;
+    return OP_pop_param_byref;
   case INS_GET_ARG:
-    return &Executor::ins_get_arg;
+    return OP_get_arg;
   case CTRL_LEAVE_BLOCK:
-    return &Executor::ins_leave_block;
+    return OP_leave_block;
   case RSV_GOSUB:
-    return &Executor::ins_gosub;
+    return OP_gosub;
   case RSV_RETURN:
-    return &Executor::ins_return;
+    return OP_return;
   case RSV_EXIT:
-    return &Executor::ins_exit;
+    return OP_exit;
   case INS_DECLARE_ARRAY:
-    return &Executor::ins_declareArray;
+    return OP_declareArray;
   case TOK_UNMINUS:
-    return &Executor::ins_unminus;
+    return OP_unminus;
   case TOK_UNPLUS:
-    return &Executor::ins_nop;
+    return OP_nop;
   case TOK_LOG_NOT:
-    return &Executor::ins_logical_not;
+    return OP_logical_not;
   case TOK_BITWISE_NOT:
-    return &Executor::ins_bitwise_not;
+    return OP_bitwise_not;
   case TOK_BSRIGHT:
-    return &Executor::ins_bitshift_right;
+    return OP_bitshift_right;
   case TOK_BSLEFT:
-    return &Executor::ins_bitshift_left;
+    return OP_bitshift_left;
   case TOK_BITAND:
-    return &Executor::ins_bitwise_and;
+    return OP_bitwise_and;
   case TOK_BITXOR:
-    return &Executor::ins_bitwise_xor;
+    return OP_bitwise_xor;
   case TOK_BITOR:
-    return &Executor::ins_bitwise_or;
+    return OP_bitwise_or;
 
   case TOK_NEQ:
-    return &Executor::ins_notequal;
+    return OP_notequal;
   case TOK_GRTHAN:
-    return &Executor::ins_greaterthan;
+    return OP_greaterthan;
   case TOK_GREQ:
-    return &Executor::ins_greaterequal;
+    return OP_greaterequal;
   case TOK_AND:
-    return &Executor::ins_logical_and;
+    return OP_logical_and;
   case TOK_OR:
-    return &Executor::ins_logical_or;
+    return OP_logical_or;
 
   case TOK_ADDMEMBER:
-    return &Executor::ins_addmember;
+    return OP_addmember;
   case TOK_DELMEMBER:
-    return &Executor::ins_removemember;
+    return OP_removemember;
   case TOK_CHKMEMBER:
-    return &Executor::ins_checkmember;
+    return OP_checkmember;
   case INS_DICTIONARY_ADDMEMBER:
-    return &Executor::ins_dictionary_addmember;
+    return OP_dictionary_addmember;
   case TOK_IN:
-    return &Executor::ins_in;
+    return OP_in;
   case INS_ADDMEMBER2:
-    return &Executor::ins_addmember2;
+    return OP_addmember2;
   case INS_ADDMEMBER_ASSIGN:
-    return &Executor::ins_addmember_assign;
+    return OP_addmember_assign;
   case CTRL_PROGEND:
-    return &Executor::ins_progend;
+    return OP_progend;
   case TOK_UNPLUSPLUS:
-    return &Executor::ins_unplusplus;
+    return OP_unplusplus;
   case TOK_UNMINUSMINUS:
-    return &Executor::ins_unminusminus;
+    return OP_unminusminus;
   case TOK_UNPLUSPLUS_POST:
-    return &Executor::ins_unplusplus_post;
+    return OP_unplusplus_post;
   case TOK_UNMINUSMINUS_POST:
-    return &Executor::ins_unminusminus_post;
+    return OP_unminusminus_post;
   case INS_SET_MEMBER_ID_UNPLUSPLUS:
-    return &Executor::ins_set_member_id_unplusplus;  // test id
+    return OP_set_member_id_unplusplus;  // test id
   case INS_SET_MEMBER_ID_UNMINUSMINUS:
-    return &Executor::ins_set_member_id_unminusminus;  // test id
+    return OP_set_member_id_unminusminus;  // test id
   case INS_SET_MEMBER_ID_UNPLUSPLUS_POST:
-    return &Executor::ins_set_member_id_unplusplus_post;  // test id
+    return OP_set_member_id_unplusplus_post;  // test id
   case INS_SET_MEMBER_ID_UNMINUSMINUS_POST:
-    return &Executor::ins_set_member_id_unminusminus_post;  // test id
+    return OP_set_member_id_unminusminus_post;  // test id
   case INS_SKIPIFTRUE_ELSE_CONSUME:
-    return &Executor::ins_skipiftrue_else_consume;
+    return OP_skipiftrue_else_consume;
+  case INS_LOCAL_LONG_COMPARE_JMPIFFALSE:
+    return OP_local_long_compare_jmpiffalse;
+  case INS_LOCAL_LOCAL_COMPARE_JMPIFFALSE:
+    return OP_local_local_compare_jmpiffalse;
+  case INS_LOCAL_LONG_ARITH_ASSIGN:
+    return OP_local_long_arith_assign;
+  case INS_LOCAL_LOCAL_ARITH_ASSIGN:
+    return OP_local_local_arith_assign;
   default:
     throw std::runtime_error( "Undefined execution token " + Clib::tostring( token.id ) );
   }
 }
 
+ExecInstrFunc Executor::GetInstrFunc( Opcode opcode )
+{
+  static const ExecInstrFunc funcs[OP_COUNT] = {
+#define EXEC_OP( name ) &Executor::ins_##name,
+#include "execops.h"
+#undef EXEC_OP
+  };
+  return funcs[opcode];
+}
+
+ExecInstrFunc Executor::GetInstrFunc( const Token& token )
+{
+  return GetInstrFunc( GetInstrOpcode( token ) );
+}
+
 void Executor::execInstr()
 {
   unsigned onPC = PC;
@@ -2997,24 +3602,100 @@ void Executor::execInstr()
   }
   catch ( std::exception& ex )
   {
-    fmt::Writer tmp;
-    tmp << "Exception in: " << prog_->name.get() << " PC=" << onPC << ": " << ex.what() << "\n";
-    if ( !run_ok_ )
-      tmp << "run_ok_ = false\n";
-    if ( PC < nLines )
-    {
-      tmp << " PC < nLines: (" << PC << " < " << nLines << ") \n";
-    }
-    if ( error_ )
-      tmp << "error_ = true\n";
-    if ( done )
-      tmp << "done = true\n";
-
+    log_exec_exception( onPC, ex.what() );
+  }
+#ifdef __unix__
+  catch ( ... )
+  {
     seterror( true );
-    POLLOG_ERROR << tmp.str();
+    POLLOG_ERROR << "Exception in " << prog_->name.get() << ", PC=" << onPC << ": unclassified\n";
 
     show_context( onPC );
   }
+#endif
+}
+
+unsigned int Executor::execInstrs( unsigned int max_instructions )
+{
+  if ( debugging_ || debug_level >= INSTRUCTIONS )
+  {
+    execInstr();
+    return 1;
+  }
+
+  unsigned onPC = PC;
+  unsigned int count = 0;
+  const bool sampling = script_sampler.running();
+  const ScriptSampler::Clock::time_point batch_start =
+      sampling ? ScriptSampler::Clock::now() : ScriptSampler::Clock::time_point();
+  try
+  {
+    passert( run_ok_ );
+    passert( PC < nLines );
+    passert( !error_ );
+    passert( !done );
+
+    const Instruction* instr = prog_->instr.data();
+    const unsigned char* opcodes = prog_->opcodes.data();
+
+// Every handler is followed by its own dispatch. With computed goto each handler gets its own
+// indirect jump, which the branch predictor can learn per opcode, instead of one shared switch.
+#if defined( __GNUC__ ) || defined( __clang__ )
+    static void* const labels[OP_COUNT] = {
+#define EXEC_OP( name ) &&op_##name,
+#include "execops.h"
+#undef EXEC_OP
+    };
+
+#define EXEC_DISPATCH()                                        \
+  if ( count == max_instructions || !run_ok_ || PC >= nLines ) \
+    goto batch_end;                                            \
+  onPC = PC++;                                                 \
+  ++instr[onPC].cycles;                                        \
+  ++count;                                                     \
+  goto* labels[opcodes[onPC]];
+
+    EXEC_DISPATCH();
+#define EXEC_OP( name )                   \
+  op_##name : ins_##name( instr[onPC] ); \
+  EXEC_DISPATCH();
+#define EXEC_OP_YIELD( name )             \
+  op_##name : ins_##name( instr[onPC] ); \
+  goto batch_end;
+#include "execops.h"
+#undef EXEC_OP
+#undef EXEC_DISPATCH
+
+#else
+    while ( count < max_instructions && run_ok_ && PC < nLines )
+    {
+      onPC = PC++;
+      const Instruction& ins = instr[onPC];
+      ++ins.cycles;
+      ++count;
+      switch ( opcodes[onPC] )
+      {
+#define EXEC_OP( name ) \
+  case OP_##name:       \
+    ins_##name( ins );  \
+    break;
+#define EXEC_OP_YIELD( name ) \
+  case OP_##name:             \
+    ins_##name( ins );        \
+    goto batch_end;
+#include "execops.h"
+#undef EXEC_OP
+      default:
+        throw std::runtime_error( "Undefined opcode " + Clib::tostring( static_cast<int>( opcodes[onPC] ) ) );
+      }
+    }
+#endif
+  batch_end:;
+  }
+  catch ( std::exception& ex )
+  {
+    log_exec_exception( onPC, ex.what() );
+  }
 #ifdef __unix__
   catch ( ... )
   {
@@ -3024,6 +3705,32 @@ void Executor::execInstr()
     show_context( onPC );
   }
 #endif
+  if ( sampling )
+    script_sampler.batch_done( *this, onPC, batch_start );
+  prog_->instr_cycles += count;
+  escript_instr_cycles += count;
+  return count;
+}
+
+void Executor::log_exec_exception( unsigned onPC, const char* what )
+{
+  fmt::Writer tmp;
+  tmp << "Exception in: " << prog_->name.get() << " PC=" << onPC << ": " << what << "\n";
+  if ( !run_ok_ )
+    tmp << "run_ok_ = false\n";
+  if ( PC < nLines )
+  {
+    tmp << " PC < nLines: (" << PC << " < " << nLines << ") \n";
+  }
+  if ( error_ )
+    tmp << "error_ = true\n";
+  if ( done )
+    tmp << "done = true\n";
+
+  seterror( true );
+  POLLOG_ERROR << tmp.str();
+
+  show_context( onPC );
 }
 
 std::string Executor::dbg_get_instruction( size_t atPC ) const
@@ -3083,7 +3790,7 @@ bool Executor::exec()
   while ( runnable() )
   {
     Clib::scripts_thread_scriptPC = PC;
-    execInstr();
+    execInstrs( 1000 );
   }
 
   return !error_;
@@ -3159,6 +3866,17 @@ void Executor::addModule( ExecutorModule* module )
 }
 
 
+void Executor::removeModule( ExecutorModule* module )
+{
+  auto itr = std::find( availmodules.begin(), availmodules.end(), module );
+  if ( itr == availmodules.end() )
+    return;
+  availmodules.erase( itr );
+  std::replace( execmodules.begin(), execmodules.end(), module,
+                static_cast<ExecutorModule*>( nullptr ) );
+  delete module;
+}
+
 ExecutorModule* Executor::findModule( const std::string& name )
 {
   unsigned idx;
@@ -3233,6 +3951,9 @@ size_t Executor::sizeEstimate() const
         size += bojectref->sizeEstimate();
     }
   }
+  size += 3 * sizeof( BObjectRefVec** ) + unusedLocals2_.size() * sizeof( BObjectRefVec* );
+  for ( const auto& bojectrefvec : unusedLocals2_ )
+    size += 3 * sizeof( BObjectRef* ) + bojectrefvec->capacity() * sizeof( BObjectRef );
   size += 3 * sizeof( ReturnContext* ) + ControlStack.size() * sizeof( ReturnContext );
 
   size += 3 * sizeof( BObjectRef* ) + Locals2->size() * sizeof( BObjectRef );
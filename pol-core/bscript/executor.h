@@ -113,6 +113,9 @@ public:
 
 
   bool setProgram( EScriptProgram* prog );
+  // forgets the program and everything it left behind, so that the executor can run another
+  // program. The modules stay attached.
+  void reset();
 
   BObjectRefVec Globals2;
 
@@ -127,6 +130,17 @@ public:
 
   ValueStackCont ValueStack;
 
+  // predecoded opcode of an instruction, see execops.h
+  enum Opcode : unsigned char
+  {
+#define EXEC_OP( name ) OP_##name,
+#include "execops.h"
+#undef EXEC_OP
+    OP_COUNT
+  };
+
+  static Opcode GetInstrOpcode( const Token& token );
+  static ExecInstrFunc GetInstrFunc( Opcode opcode );
   static ExecInstrFunc GetInstrFunc( const Token& token );
 
   /*
@@ -223,11 +237,17 @@ public:
 
   void addModule( ExecutorModule* module );  // NOTE, executor deletes its modules when done
   ExecutorModule* findModule( const std::string& name );
+  void removeModule( ExecutorModule* module );  // and deletes it
 
   ModuleFunction* current_module_function;
   // NOTE: the debugger code expects these to be virtual..
   void execFunc( const Token& token );
   void execInstr();
+  // Runs up to max_instructions instructions with the predecoded opcodes of the program and
+  // returns the number of executed instructions. Stops early when the script is no longer
+  // runnable or after an instruction which can block (module functions and methods).
+  // While debugging or tracing it executes a single instruction via execInstr.
+  unsigned int execInstrs( unsigned int max_instructions );
 
   void ins_nop( const Instruction& ins );
   void ins_jmpiftrue( const Instruction& ins );
@@ -349,6 +369,12 @@ public:
 
   void ins_funcref( const Instruction& ins );
 
+  // superinstructions, see Compiler::SuperinstructionOptimizer
+  void ins_local_long_compare_jmpiffalse( const Instruction& ins );
+  void ins_local_local_compare_jmpiffalse( const Instruction& ins );
+  void ins_local_long_arith_assign( const Instruction& ins );
+  void ins_local_local_arith_assign( const Instruction& ins );
+
   static int ins_casejmp_findlong( const Token& token, BLong* blong );
   static int ins_casejmp_findstring( const Token& token, String* bstringimp );
   static int ins_casejmp_finddefault( const Token& token );
@@ -419,6 +445,21 @@ private:
 
   BObjectImp* func_result_;
 
+  void log_exec_exception( unsigned onPC, const char* what );
+  // integer operands of a superinstruction, false if it has to run as its single instructions
+  bool superinstruction_operands( const Instruction& ins, bool rhs_is_local, int& lhs,
+                                  int& rhs ) const;
+  void assign_local_long( unsigned varnum, int value );
+  bool element_only_read( unsigned pos ) const;
+
+  // Locals of a new function frame. The vectors of returned frames are kept (cleared, with their
+  // capacity) and reused, so calling a function doesn't allocate once the call depth was reached
+  // before. Frames above MAX_UNUSED_FRAMES are deleted, a deep recursion doesn't keep its memory.
+  static const size_t MAX_UNUSED_FRAMES = 16;
+  void enter_frame();
+  void leave_frame();
+  std::vector<BObjectRefVec*> unusedLocals2_;
+
 private:  // not implemented
   Executor( const Executor& exec );
   Executor& operator=( const Executor& exec );
@@ -14,6 +14,14 @@ class Executor;
 class Instruction;
 
 typedef void ( Executor::*ExecInstrFunc )( const Instruction& );
+
+// Per instruction storage for member lookups (INS_GET_MEMBER_ID): receiver identifies the
+// class the cached resolution is valid for, the meaning of resolution is up to that class.
+struct InlineCache
+{
+  const void* receiver = nullptr;
+  int resolution = 0;
+};
 }
 }
 #endif
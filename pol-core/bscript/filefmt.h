@@ -35,6 +35,7 @@ namespace Bscript
 #define ESCRIPT_FILE_VER_000C 0x000C
 #define ESCRIPT_FILE_VER_000D 0x000D
 #define ESCRIPT_FILE_VER_000F 0x000F /*unicode*/
+#define ESCRIPT_FILE_VER_0010 0x0010 /*superinstructions*/
 
 /*
     NOTE: Update ESCRIPT_FILE_VER_CURRENT when you make a
@@ -42,7 +43,7 @@ namespace Bscript
     and report this to users when an older compiled version
     is attempted to be executed - TJ
     */
-#define ESCRIPT_FILE_VER_CURRENT ( ESCRIPT_FILE_VER_000F )
+#define ESCRIPT_FILE_VER_CURRENT ( ESCRIPT_FILE_VER_0010 )
 
 struct BSCRIPT_FILE_HDR
 {
@@ -10,6 +10,7 @@
 #include "bobject.h"
 #endif
 
+#include <memory>
 #include <stack>
 #include <string>
 
@@ -29,12 +30,18 @@ public:
     YES,  // performs unicode sanitize should be done for every external value (assuming ISO8859)
     NO    // performs no unicode sanitize should only be used for internal usage
   };
-  String() : BObjectImp( OTString ), value_( "" ) {}
+  String() : BObjectImp( OTString ), value_( std::make_shared<std::string>() ) {}
   String( const char* str, int nchars, Tainted san = Tainted::NO );
   explicit String( const char* str, Tainted san = Tainted::NO );
   explicit String( const std::string& str, Tainted san = Tainted::NO );
   explicit String( BObjectImp& objimp );
+  // shares the character buffer with str, the first modification of either one copies it
   String( const String& str ) : BObjectImp( OTString ), value_( str.value_ ) {}
+  // shares a constant buffer, like the string literals of a program
+  explicit String( const std::shared_ptr<std::string>& buffer )
+      : BObjectImp( OTString ), value_( buffer )
+  {
+  }
   virtual ~String() = default;
 
 private:
@@ -58,8 +65,8 @@ public:
   void EStrReplace( String* str1, String* str2 );
   void ESubStrReplace( String* replace_with, unsigned int index, unsigned int len );
 
-  const char* data() const { return value_.c_str(); }
-  const std::string& value() const { return value_; }
+  const char* data() const { return value_->c_str(); }
+  const std::string& value() const { return *value_; }
   size_t length() const;
   void toUpper();
   void toLower();
@@ -75,7 +82,7 @@ public:
 
   String& operator=( const char* s )
   {
-    value_ = s;
+    value_ = std::make_shared<std::string>( s );
     return *this;
   }
   String& operator=( const String& str )
@@ -87,7 +94,9 @@ public:
 
 private:
   void remove( const std::string& s );
-  virtual bool isTrue() const override { return !value_.empty(); }
+  virtual bool isTrue() const override { return !value_->empty(); }
+  // the buffer for modifications, copies it first if it is shared
+  std::string& mutable_value();
 
 public:
   virtual BObjectImp* selfPlusObjImp( const BObjectImp& objimp ) const override;
@@ -126,8 +135,8 @@ public:
 
   virtual BObjectImp* array_assign( BObjectImp* idx, BObjectImp* target, bool copy ) override;
 
-  virtual std::string getStringRep() const override { return value_; }
-  virtual std::string getFormattedStringRep() const override { return "\"" + value_ + "\""; }
+  virtual std::string getStringRep() const override { return *value_; }
+  virtual std::string getFormattedStringRep() const override { return "\"" + *value_ + "\""; }
   virtual void printOn( std::ostream& ) const override;
 
   bool compare( const String& str ) const;
@@ -145,7 +154,7 @@ protected:
 private:
   size_t getBytePosition( std::string::const_iterator* itr, size_t codeindex ) const;
 
-  std::string value_;
+  std::shared_ptr<std::string> value_;
   friend class SubString;
 };
 
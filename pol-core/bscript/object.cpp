@@ -938,6 +938,10 @@ BObjectRef BObjectImp::get_member_id( const int id )
 
   return get_member( memb->code );
 }
+BObjectRef BObjectImp::get_member_id_cached( const int id, InlineCache& /*cache*/ )
+{
+  return get_member_id( id );
+}
 BObjectRef BObjectImp::set_member_id( const int id, BObjectImp* valueimp, bool copy )
 {
   ObjMember* memb = getObjMember( id );
@@ -62,7 +62,7 @@ void ObjArray::printOn( std::ostream& os ) const
 
 void String::printOn( std::ostream& os ) const
 {
-  os << '\"' << value_ << '\"';
+  os << '\"' << *value_ << '\"';
 }
 
 #if 0
@@ -0,0 +1,137 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "scriptsampler.h"
+
+#include <ostream>
+
+#include "../clib/strutil.h"
+#include "eprog.h"
+#include "executor.h"
+#include "fmodule.h"
+#include "objmethods.h"
+
+namespace Pol
+{
+namespace Bscript
+{
+ScriptSampler script_sampler;
+
+ScriptSampler::ScriptSampler()
+    : running_( false ),
+      interval_( Clock::duration::zero() ),
+      elapsed_( Clock::duration::zero() ),
+      samples_( 0 ),
+      stacks_(),
+      without_debug_info_()
+{
+}
+
+void ScriptSampler::start( unsigned int samples_per_second )
+{
+  if ( samples_per_second == 0 )
+    samples_per_second = 1;
+  interval_ = std::chrono::duration_cast<Clock::duration>( std::chrono::seconds( 1 ) ) /
+              samples_per_second;
+  if ( interval_ <= Clock::duration::zero() )
+    interval_ = Clock::duration( 1 );
+  elapsed_ = Clock::duration::zero();
+  running_ = true;
+}
+
+void ScriptSampler::stop()
+{
+  running_ = false;
+}
+
+void ScriptSampler::batch_done( const Executor& ex, unsigned last_PC,
+                                Clock::time_point batch_start )
+{
+  elapsed_ += Clock::now() - batch_start;
+  if ( elapsed_ < interval_ )
+    return;
+  EScriptProgram& prog = const_cast<EScriptProgram&>( *ex.prog() );
+  if ( last_PC >= prog.instr.size() )
+    return;
+  // a module function that blocked for several intervals gets all of them
+  u64 count = static_cast<u64>( elapsed_ / interval_ );
+  elapsed_ %= interval_;
+
+  std::string stack = prog.name.get();
+  for ( const auto& rc : ex.ControlStack )
+  {
+    if ( rc.PC == 0 )
+      continue;
+    std::string name = function_name( prog, rc.PC - 1 );
+    if ( !name.empty() )
+      stack += ";" + name;
+  }
+  std::string name = function_name( prog, last_PC );
+  if ( !name.empty() )
+    stack += ";" + name;
+
+  const Token& token = prog.instr[last_PC].token;
+  switch ( prog.opcodes[last_PC] )
+  {
+  case Executor::OP_func:
+  {
+    const FunctionalityModule* module = prog.modules[token.module];
+    stack += ";" + std::string( module->modulename.get() ) +
+             "::" + std::string( module->functions[token.lval]->name.get() );
+    break;
+  }
+  case Executor::OP_call_method:
+    stack += ";." + std::string( token.tokval() );
+    break;
+  case Executor::OP_call_method_id:
+  {
+    const ObjMethod* method = getObjMethod( token.lval );
+    if ( method != nullptr )
+      stack += ";." + std::string( method->code );
+    break;
+  }
+  default:
+    break;
+  }
+
+  stacks_[stack] += count;
+  samples_ += count;
+}
+
+// name of the user function containing PC, empty for the program body
+std::string ScriptSampler::function_name( EScriptProgram& prog, unsigned PC )
+{
+  if ( !prog.debug_loaded )
+  {
+    std::string progname = prog.name.get();
+    if ( without_debug_info_.count( progname ) || prog.read_dbg_file() != 0 )
+    {
+      without_debug_info_.insert( progname );
+      return "@" + Clib::tostring( PC );
+    }
+  }
+  for ( const auto& func : prog.dbg_functions )
+  {
+    if ( PC >= func.firstPC && PC <= func.lastPC )
+      return func.name;
+  }
+  return "";
+}
+
+void ScriptSampler::write( std::ostream& os ) const
+{
+  for ( const auto& stack : stacks_ )
+    os << stack.first << ' ' << stack.second << '\n';
+}
+
+void ScriptSampler::clear()
+{
+  stacks_.clear();
+  samples_ = 0;
+  elapsed_ = Clock::duration::zero();
+}
+}
+}
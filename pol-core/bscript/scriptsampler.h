@@ -0,0 +1,69 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef BSCRIPT_SCRIPTSAMPLER_H
+#define BSCRIPT_SCRIPTSAMPLER_H
+
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <set>
+#include <string>
+
+#include "../clib/rawtypes.h"
+
+namespace Pol
+{
+namespace Bscript
+{
+class EScriptProgram;
+class Executor;
+
+/**
+ * Sampling profiler for scripts, switched on and off at runtime.
+ *
+ * While it runs, the executors add up the time their instruction batches take. Every time
+ * another interval of script time passed, the call stack of the running script is recorded:
+ * the script, its user functions (resolved through the .dbg file) and, if the batch ended in a
+ * module function or method call, that call.
+ * The stacks are counted in collapsed form ("script;function;function;module::Func count"),
+ * which flamegraph.pl and most other flame graph tools read directly.
+ */
+class ScriptSampler
+{
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  ScriptSampler();
+
+  void start( unsigned int samples_per_second );
+  void stop();
+  bool running() const { return running_; }
+
+  // accounts the run time of an instruction batch which ended with the instruction at last_PC
+  void batch_done( const Executor& ex, unsigned last_PC, Clock::time_point batch_start );
+
+  // writes the collapsed stacks, one per line
+  void write( std::ostream& os ) const;
+  void clear();
+  u64 samples() const { return samples_; }
+
+private:
+  std::string function_name( EScriptProgram& prog, unsigned PC );
+
+  bool running_;
+  Clock::duration interval_;
+  Clock::duration elapsed_;
+  u64 samples_;
+  std::map<std::string, u64> stacks_;
+  // programs whose .dbg file couldn't be read, to try it only once
+  std::set<std::string> without_debug_info_;
+};
+
+extern ScriptSampler script_sampler;
+}
+}
+#endif
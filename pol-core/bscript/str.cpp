@@ -37,49 +37,63 @@ namespace Pol
 {
 namespace Bscript
 {
-String::String( BObjectImp& objimp ) : BObjectImp( OTString ), value_( objimp.getStringRep() ) {}
+String::String( BObjectImp& objimp )
+    : BObjectImp( OTString ), value_( std::make_shared<std::string>( objimp.getStringRep() ) )
+{
+}
 
-String::String( const char* s, int len, Tainted san ) : BObjectImp( OTString ), value_( s, len )
+String::String( const char* s, int len, Tainted san )
+    : BObjectImp( OTString ), value_( std::make_shared<std::string>( s, len ) )
 {
   if ( san == Tainted::YES )
-    Clib::sanitizeUnicodeWithIso( &value_ );
+    Clib::sanitizeUnicodeWithIso( value_.get() );
 }
 
 String::String( const std::string& str, std::string::size_type pos, std::string::size_type n )
-    : BObjectImp( OTString ), value_( str, pos, n )
+    : BObjectImp( OTString ), value_( std::make_shared<std::string>( str, pos, n ) )
 {
 }
 
-String::String( const char* str, Tainted san ) : BObjectImp( OTString ), value_( str )
+String::String( const char* str, Tainted san )
+    : BObjectImp( OTString ), value_( std::make_shared<std::string>( str ) )
 {
   if ( san == Tainted::YES )
-    Clib::sanitizeUnicodeWithIso( &value_ );
+    Clib::sanitizeUnicodeWithIso( value_.get() );
 }
 
-String::String( const std::string& str, Tainted san ) : BObjectImp( OTString ), value_( str )
+String::String( const std::string& str, Tainted san )
+    : BObjectImp( OTString ), value_( std::make_shared<std::string>( str ) )
 {
   if ( san == Tainted::YES )
-    Clib::sanitizeUnicodeWithIso( &value_ );
+    Clib::sanitizeUnicodeWithIso( value_.get() );
+}
+
+std::string& String::mutable_value()
+{
+  if ( value_.use_count() > 1 )
+    value_ = std::make_shared<std::string>( *value_ );
+  return *value_;
 }
+
 String* String::StrStr( int begin, int len ) const
 {
-  auto itr = value_.cbegin();
+  auto itr = value_->cbegin();
   --begin;
   size_t startpos = getBytePosition( &itr, begin );
   size_t endpos = getBytePosition( &itr, len );
   if ( startpos != std::string::npos )
-    return new String( value_.substr( startpos, endpos - startpos ) );
-  return new String( value_ );
+    return new String( value_->substr( startpos, endpos - startpos ) );
+  return new String( *this );
 }
 
 size_t String::length() const
 {
-  return utf8::unchecked::distance( value_.begin(), value_.end() );
+  return utf8::unchecked::distance( value_->begin(), value_->end() );
 }
 
 String* String::ETrim( const char* CRSet, int type ) const
 {
-  std::string tmp = value_;
+  std::string tmp = *value_;
 
   if ( type == 1 )  // This is for Leading Only.
   {
@@ -122,30 +136,30 @@ String* String::ETrim( const char* CRSet, int type ) const
 void String::EStrReplace( String* str1, String* str2 )
 {
   std::string::size_type valpos = 0;
-  while ( std::string::npos != ( valpos = value_.find( str1->value_, valpos ) ) )
+  while ( std::string::npos != ( valpos = value_->find( str1->value(), valpos ) ) )
   {
-    value_.replace( valpos, str1->value_.size(), str2->value_ );
-    valpos += str2->value_.size();
+    mutable_value().replace( valpos, str1->value().size(), str2->value() );
+    valpos += str2->value().size();
   }
 }
 
 void String::ESubStrReplace( String* replace_with, unsigned int index, unsigned int len )
 {
-  auto itr = value_.cbegin();
+  auto itr = value_->cbegin();
   size_t begin = getBytePosition( &itr, index - 1 );
   size_t end = getBytePosition( &itr, len );
   if ( begin != std::string::npos )
-    value_.replace( begin, end - begin, replace_with->value_ );
+    mutable_value().replace( begin, end - begin, replace_with->value() );
 }
 
 std::string String::pack() const
 {
-  return "s" + value_;
+  return "s" + *value_;
 }
 
 void String::packonto( std::ostream& os ) const
 {
-  os << "S" << value_.size() << ":" << value_;
+  os << "S" << value_->size() << ":" << *value_;
 }
 void String::packonto( std::ostream& os, const std::string& value )
 {
@@ -196,7 +210,7 @@ BObjectImp* String::unpackWithLen( std::istream& is )
 
 size_t String::sizeEstimate() const
 {
-  return sizeof( String ) + value_.capacity();
+  return sizeof( String ) + value_->capacity() / value_.use_count();
 }
 
 /*
@@ -207,14 +221,14 @@ size_t String::sizeEstimate() const
 int String::find( int begin, const char* target ) const
 {
   // returns -1 when begin is out of range for string
-  auto itr = value_.cbegin();
+  auto itr = value_->cbegin();
   size_t pos = getBytePosition( &itr, begin );
-  pos = value_.find( target, pos );
+  pos = value_->find( target, pos );
   if ( pos == std::string::npos )
     return -1;
   else
   {
-    pos = utf8::unchecked::distance( value_.cbegin(), std::next( value_.cbegin(), pos ) );
+    pos = utf8::unchecked::distance( value_->cbegin(), std::next( value_->cbegin(), pos ) );
     return static_cast<int>( pos );
   }
 }
@@ -224,7 +238,7 @@ unsigned int String::SafeCharAmt() const
   unsigned int strlen = static_cast<unsigned int>( length() );
   for ( unsigned int i = 0; i < strlen; ++i )
   {
-    unsigned char tmp = value_[i];
+    unsigned char tmp = ( *value_ )[i];
     if ( tmp >= 0x80 )  // Ascii range
       return i;
     else if ( isalnum( tmp ) )  // a-z A-Z 0-9
@@ -250,23 +264,23 @@ BObjectImp* String::selfPlusObjImp( const BObjectImp& objimp ) const
 }
 BObjectImp* String::selfPlusObj( const BObjectImp& objimp ) const
 {
-  return new String( value_ + objimp.getStringRep() );
+  return new String( *value_ + objimp.getStringRep() );
 }
 BObjectImp* String::selfPlusObj( const BLong& objimp ) const
 {
-  return new String( value_ + objimp.getStringRep() );
+  return new String( *value_ + objimp.getStringRep() );
 }
 BObjectImp* String::selfPlusObj( const Double& objimp ) const
 {
-  return new String( value_ + objimp.getStringRep() );
+  return new String( *value_ + objimp.getStringRep() );
 }
 BObjectImp* String::selfPlusObj( const String& objimp ) const
 {
-  return new String( value_ + objimp.getStringRep() );
+  return new String( *value_ + objimp.getStringRep() );
 }
 BObjectImp* String::selfPlusObj( const ObjArray& objimp ) const
 {
-  return new String( value_ + objimp.getStringRep() );
+  return new String( *value_ + objimp.getStringRep() );
 }
 void String::selfPlusObjImp( BObjectImp& objimp, BObject& obj )
 {
@@ -274,31 +288,31 @@ void String::selfPlusObjImp( BObjectImp& objimp, BObject& obj )
 }
 void String::selfPlusObj( BObjectImp& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  mutable_value() += objimp.getStringRep();
 }
 void String::selfPlusObj( BLong& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  mutable_value() += objimp.getStringRep();
 }
 void String::selfPlusObj( Double& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  mutable_value() += objimp.getStringRep();
 }
 void String::selfPlusObj( String& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  mutable_value() += objimp.getStringRep();
 }
 void String::selfPlusObj( ObjArray& objimp, BObject& /*obj*/ )
 {
-  value_ += objimp.getStringRep();
+  mutable_value() += objimp.getStringRep();
 }
 
 
 void String::remove( const std::string& rm )
 {
-  auto pos = value_.find( rm );
+  auto pos = value_->find( rm );
   if ( pos != std::string::npos )
-    value_.erase( pos, rm.size() );
+    mutable_value().erase( pos, rm.size() );
 }
 
 BObjectImp* String::selfMinusObjImp( const BObjectImp& objimp ) const
@@ -326,7 +340,7 @@ BObjectImp* String::selfMinusObj( const Double& objimp ) const
 BObjectImp* String::selfMinusObj( const String& objimp ) const
 {
   String* tmp = (String*)copy();
-  tmp->remove( objimp.value_ );
+  tmp->remove( objimp.value() );
   return tmp;
 }
 BObjectImp* String::selfMinusObj( const ObjArray& objimp ) const
@@ -353,7 +367,7 @@ void String::selfMinusObj( Double& objimp, BObject& /*obj*/ )
 }
 void String::selfMinusObj( String& objimp, BObject& /*obj*/ )
 {
-  remove( objimp.value_ );
+  remove( objimp.value() );
 }
 void String::selfMinusObj( ObjArray& objimp, BObject& /*obj*/ )
 {
@@ -363,7 +377,7 @@ void String::selfMinusObj( ObjArray& objimp, BObject& /*obj*/ )
 bool String::operator==( const BObjectImp& objimp ) const
 {
   if ( objimp.isa( OTString ) )
-    return ( value_ == static_cast<const String&>( objimp ).value_ );
+    return ( *value_ == static_cast<const String&>( objimp ).value() );
 
   if ( objimp.isa( OTBoolean ) )
     return isTrue() == static_cast<const BBoolean&>( objimp ).isTrue();
@@ -373,7 +387,7 @@ bool String::operator==( const BObjectImp& objimp ) const
 bool String::operator<( const BObjectImp& objimp ) const
 {
   if ( objimp.isa( OTString ) )
-    return ( value_ < static_cast<const String&>( objimp ).value_ );
+    return ( *value_ < static_cast<const String&>( objimp ).value() );
 
   return base::operator<( objimp );
 }
@@ -401,19 +415,20 @@ void String::toUpper()
 {
   if ( !hasUTF8Characters() )
   {
-    Clib::mkupperASCII( value_ );
+    Clib::mkupperASCII( mutable_value() );
     return;
   }
 #ifndef WINDOWS
-  std::vector<wchar_t> codes = convertutf8<wchar_t>( value_ );
-  value_.clear();
+  std::vector<wchar_t> codes = convertutf8<wchar_t>( *value_ );
+  std::string& result = mutable_value();
+  result.clear();
   for ( const auto& c : codes )
   {
-    utf8::unchecked::append( std::towupper( c ), std::back_inserter( value_ ) );
+    utf8::unchecked::append( std::towupper( c ), std::back_inserter( result ) );
   }
 #else
   std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-  std::wstring str = converter.from_bytes( value_ );
+  std::wstring str = converter.from_bytes( *value_ );
 
   int len = LCMapStringW( LOCALE_USER_DEFAULT, LCMAP_UPPERCASE | LCMAP_LINGUISTIC_CASING, &str[0],
                           static_cast<int>( str.size() ), 0, 0 );
@@ -423,7 +438,7 @@ void String::toUpper()
   {
     LCMapStringW( LOCALE_USER_DEFAULT, LCMAP_UPPERCASE | LCMAP_LINGUISTIC_CASING, &str[0],
                   static_cast<int>( str.size() ), &str[0], static_cast<int>( str.size() ) );
-    value_ = converter.to_bytes( str );
+    mutable_value() = converter.to_bytes( str );
   }
   else
   {
@@ -431,7 +446,7 @@ void String::toUpper()
     buf.reserve( len );
     LCMapStringW( LOCALE_USER_DEFAULT, LCMAP_UPPERCASE | LCMAP_LINGUISTIC_CASING, &str[0],
                   static_cast<int>( str.size() ), &buf[0], static_cast<int>( buf.size() ) );
-    value_ = converter.to_bytes( buf );
+    mutable_value() = converter.to_bytes( buf );
   }
 #endif
 }
@@ -440,19 +455,20 @@ void String::toLower()
 {
   if ( !hasUTF8Characters() )
   {
-    Clib::mklowerASCII( value_ );
+    Clib::mklowerASCII( mutable_value() );
     return;
   }
 #ifndef WINDOWS
-  std::vector<wchar_t> codes = convertutf8<wchar_t>( value_ );
-  value_.clear();
+  std::vector<wchar_t> codes = convertutf8<wchar_t>( *value_ );
+  std::string& result = mutable_value();
+  result.clear();
   for ( const auto& c : codes )
   {
-    utf8::unchecked::append( std::towlower( c ), std::back_inserter( value_ ) );
+    utf8::unchecked::append( std::towlower( c ), std::back_inserter( result ) );
   }
 #else
   std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-  std::wstring str = converter.from_bytes( value_ );
+  std::wstring str = converter.from_bytes( *value_ );
 
   int len = LCMapStringW( LOCALE_USER_DEFAULT, LCMAP_LOWERCASE | LCMAP_LINGUISTIC_CASING, &str[0],
                           static_cast<int>( str.size() ), 0, 0 );
@@ -462,7 +478,7 @@ void String::toLower()
   {
     LCMapStringW( LOCALE_USER_DEFAULT, LCMAP_LOWERCASE | LCMAP_LINGUISTIC_CASING, &str[0],
                   static_cast<int>( str.size() ), &str[0], static_cast<int>( str.size() ) );
-    value_ = converter.to_bytes( str );
+    mutable_value() = converter.to_bytes( str );
   }
   else
   {
@@ -470,20 +486,20 @@ void String::toLower()
     buf.reserve( len );
     LCMapStringW( LOCALE_USER_DEFAULT, LCMAP_LOWERCASE | LCMAP_LINGUISTIC_CASING, &str[0],
                   static_cast<int>( str.size() ), &buf[0], static_cast<int>( buf.size() ) );
-    value_ = converter.to_bytes( buf );
+    mutable_value() = converter.to_bytes( buf );
   }
 #endif
 }
 
 size_t String::getBytePosition( std::string::const_iterator* itr, size_t codeindex ) const
 {
-  auto itr_end = value_.cend();
+  auto itr_end = value_->cend();
   for ( size_t i = 0; i < codeindex && *itr != itr_end; ++i )
     utf8::unchecked::next( *itr );
 
   if ( *itr != itr_end )
   {
-    return std::distance( value_.cbegin(), *itr );
+    return std::distance( value_->cbegin(), *itr );
   }
   return std::string::npos;
 }
@@ -496,20 +512,20 @@ BObjectImp* String::array_assign( BObjectImp* idx, BObjectImp* target, bool /*co
   if ( idx->isa( OTString ) )
   {
     String& rtstr = (String&)*idx;
-    pos = value_.find( rtstr.value_ );
-    len = rtstr.value_.size();
+    pos = value_->find( rtstr.value() );
+    len = rtstr.value().size();
   }
   else if ( idx->isa( OTLong ) )
   {
     BLong& lng = (BLong&)*idx;
     len = 1;
     pos = lng.value() - 1;
-    auto itr = value_.cbegin();
+    auto itr = value_->cbegin();
     pos = getBytePosition( &itr, pos );
     if ( pos != std::string::npos )
     {
       utf8::unchecked::next( itr );
-      len = std::distance( value_.cbegin(), itr ) - pos;
+      len = std::distance( value_->cbegin(), itr ) - pos;
     }
     else
       pos = std::string::npos;
@@ -519,12 +535,12 @@ BObjectImp* String::array_assign( BObjectImp* idx, BObjectImp* target, bool /*co
     Double& dbl = (Double&)*idx;
     pos = static_cast<std::string::size_type>( dbl.value() ) - 1;
     len = 1;
-    auto itr = value_.cbegin();
+    auto itr = value_->cbegin();
     pos = getBytePosition( &itr, pos );
     if ( pos != std::string::npos )
     {
       utf8::unchecked::next( itr );
-      len = std::distance( value_.cbegin(), itr ) - pos;
+      len = std::distance( value_->cbegin(), itr ) - pos;
     }
     else
       pos = std::string::npos;
@@ -539,7 +555,7 @@ BObjectImp* String::array_assign( BObjectImp* idx, BObjectImp* target, bool /*co
     if ( target->isa( OTString ) )
     {
       String* target_str = (String*)target;
-      value_.replace( pos, len, target_str->value_ );
+      mutable_value().replace( pos, len, target_str->value() );
     }
     return this;
   }
@@ -568,10 +584,10 @@ BObjectRef String::OperMultiSubscriptAssign( std::stack<BObjectRef>& indices, BO
   {
     BLong& lng = (BLong&)start;
     index = (size_t)lng.value();
-    if ( index == 0 || index > value_.size() )
+    if ( index == 0 || index > value_->size() )
       return BObjectRef( new BError( "Subscript out of range" ) );
     --index;
-    auto itr = value_.cbegin();
+    auto itr = value_->cbegin();
     index = getBytePosition( &itr, index );
     if ( index == std::string::npos )
       return BObjectRef( new BError( "Subscript out of range" ) );
@@ -579,7 +595,7 @@ BObjectRef String::OperMultiSubscriptAssign( std::stack<BObjectRef>& indices, BO
   else if ( start.isa( OTString ) )
   {
     String& rtstr = (String&)start;
-    std::string::size_type pos = value_.find( rtstr.value_ );
+    std::string::size_type pos = value_->find( rtstr.value() );
     if ( pos != std::string::npos )
       index = static_cast<size_t>( pos );
     else
@@ -608,7 +624,7 @@ BObjectRef String::OperMultiSubscriptAssign( std::stack<BObjectRef>& indices, BO
   {
     return BObjectRef( copy() );
   }
-  auto itr = value_.cbegin();
+  auto itr = value_->cbegin();
   std::advance( itr, index );
   size_t index_len = getBytePosition( &itr, len );
 
@@ -620,7 +636,7 @@ BObjectRef String::OperMultiSubscriptAssign( std::stack<BObjectRef>& indices, BO
   if ( target->isa( OTString ) )
   {
     String* target_str = (String*)target;
-    value_.replace( index, len, target_str->value_ );
+    mutable_value().replace( index, len, target_str->value() );
   }
   else
   {
@@ -650,10 +666,10 @@ BObjectRef String::OperMultiSubscript( std::stack<BObjectRef>& indices )
   {
     BLong& lng = (BLong&)start;
     index = (size_t)lng.value();
-    if ( index == 0 || index > value_.size() )
+    if ( index == 0 || index > value_->size() )
       return BObjectRef( new BError( "Subscript out of range" ) );
     --index;
-    auto itr = value_.cbegin();
+    auto itr = value_->cbegin();
     index = getBytePosition( &itr, index );
     if ( index == std::string::npos )
       return BObjectRef( new BError( "Subscript out of range" ) );
@@ -661,7 +677,7 @@ BObjectRef String::OperMultiSubscript( std::stack<BObjectRef>& indices )
   else if ( start.isa( OTString ) )
   {
     String& rtstr = (String&)start;
-    std::string::size_type pos = value_.find( rtstr.value_ );
+    std::string::size_type pos = value_->find( rtstr.value() );
     if ( pos != std::string::npos )
       index = static_cast<unsigned int>( pos );
     else
@@ -690,7 +706,7 @@ BObjectRef String::OperMultiSubscript( std::stack<BObjectRef>& indices )
   {
     return BObjectRef( copy() );
   }
-  auto itr = value_.cbegin();
+  auto itr = value_->cbegin();
   std::advance( itr, index );
   size_t index_len = getBytePosition( &itr, len );
 
@@ -698,7 +714,7 @@ BObjectRef String::OperMultiSubscript( std::stack<BObjectRef>& indices )
     len = index_len - index;
   else
     len = index_len;
-  return BObjectRef( new String( value_, index, len ) );
+  return BObjectRef( new String( *value_, index, len ) );
 }
 
 BObjectRef String::OperSubscript( const BObject& rightobj )
@@ -713,17 +729,17 @@ BObjectRef String::OperSubscript( const BObject& rightobj )
 
     size_t index = (size_t)lng.value();
 
-    if ( index == 0 || index > value_.size() )
+    if ( index == 0 || index > value_->size() )
       return BObjectRef( new BError( "Subscript out of range" ) );
 
     --index;
-    auto itr = value_.cbegin();
+    auto itr = value_->cbegin();
     index = getBytePosition( &itr, index );
     if ( index != std::string::npos )
     {
       utf8::unchecked::next( itr );
-      int len = static_cast<int>( std::distance( value_.cbegin(), itr ) - index );
-      return BObjectRef( new BObject( new String( value_.c_str() + index, len ) ) );
+      int len = static_cast<int>( std::distance( value_->cbegin(), itr ) - index );
+      return BObjectRef( new BObject( new String( value_->c_str() + index, len ) ) );
     }
     return BObjectRef( new BError( "Subscript out of range" ) );
   }
@@ -735,31 +751,31 @@ BObjectRef String::OperSubscript( const BObject& rightobj )
       return BObjectRef( new BError( "Subscript out of range" ) );
     size_t index = (size_t)dbl.value();
 
-    if ( index == 0 || index > value_.size() )
+    if ( index == 0 || index > value_->size() )
       return BObjectRef( new BError( "Subscript out of range" ) );
 
     --index;
-    auto itr = value_.cbegin();
+    auto itr = value_->cbegin();
     index = getBytePosition( &itr, index );
     if ( index != std::string::npos )
     {
       utf8::unchecked::next( itr );
-      int len = static_cast<int>( std::distance( value_.cbegin(), itr ) - index );
-      return BObjectRef( new BObject( new String( value_.c_str() + index, len ) ) );
+      int len = static_cast<int>( std::distance( value_->cbegin(), itr ) - index );
+      return BObjectRef( new BObject( new String( value_->c_str() + index, len ) ) );
     }
     return BObjectRef( new BError( "Subscript out of range" ) );
   }
   else if ( right.isa( OTString ) )
   {
     String& rtstr = (String&)right;
-    auto pos = value_.find( rtstr.value_ );
+    auto pos = value_->find( rtstr.value() );
     if ( pos != std::string::npos )
     {
-      auto itr = value_.cbegin();
+      auto itr = value_->cbegin();
       std::advance( itr, pos );
       utf8::unchecked::next( itr );
-      size_t len = std::distance( value_.cbegin(), itr ) - pos;
-      return BObjectRef( new BObject( new String( value_, pos, len ) ) );
+      size_t len = std::distance( value_->cbegin(), itr ) - pos;
+      return BObjectRef( new BObject( new String( *value_, pos, len ) ) );
     }
     else
       return BObjectRef( new UninitObject );
@@ -956,15 +972,15 @@ BObjectImp* String::call_method_id( const int id, Executor& ex, bool /*forcebuil
       // Tells whether last found tag was an integer
       bool last_tag_was_int = true;
 
-      while ( ( tag_start_pos = value_.find( '{', str_pos ) ) != std::string::npos )
+      while ( ( tag_start_pos = value_->find( '{', str_pos ) ) != std::string::npos )
       {
-        if ( ( tag_stop_pos = value_.find( '}', tag_start_pos ) ) != std::string::npos )
+        if ( ( tag_stop_pos = value_->find( '}', tag_start_pos ) ) != std::string::npos )
         {
-          result << value_.substr( str_pos, tag_start_pos - str_pos );
+          result << value_->substr( str_pos, tag_start_pos - str_pos );
           str_pos = tag_stop_pos + 1;
 
           std::string tag_body =
-              value_.substr( tag_start_pos + 1, ( tag_stop_pos - tag_start_pos ) - 1 );
+              value_->substr( tag_start_pos + 1, ( tag_stop_pos - tag_start_pos ) - 1 );
 
           tag_start_pos = tag_body.find_first_not_of( w_spaces );
           tag_stop_pos = tag_body.find_last_not_of( w_spaces );
@@ -1064,9 +1080,9 @@ BObjectImp* String::call_method_id( const int id, Executor& ex, bool /*forcebuil
         }
       }
 
-      if ( str_pos < value_.length() )
+      if ( str_pos < value_->length() )
       {
-        result << value_.substr( str_pos, std::string::npos );
+        result << value_->substr( str_pos, std::string::npos );
       }
 
       return new String( result.str() );
@@ -1096,7 +1112,7 @@ BObjectImp* String::call_method_id( const int id, Executor& ex, bool /*forcebuil
           if ( bo == nullptr )
             continue;
           if ( !first )
-            joined << value_;
+            joined << *value_;
           else
             first = false;
           joined << bo->impptr()->getStringRep();
@@ -1114,7 +1130,7 @@ BObjectImp* String::call_method_id( const int id, Executor& ex, bool /*forcebuil
 
 bool String::hasUTF8Characters() const
 {
-  return hasUTF8Characters( value_ );
+  return hasUTF8Characters( *value_ );
 }
 
 bool String::hasUTF8Characters( const std::string& str )
@@ -1130,7 +1146,7 @@ bool String::hasUTF8Characters( const std::string& str )
 std::vector<unsigned short> String::toUTF16() const
 {
   std::vector<unsigned short> u16;
-  utf8::unchecked::utf8to16( value_.begin(), value_.end(), std::back_inserter( u16 ) );
+  utf8::unchecked::utf8to16( value_->begin(), value_->end(), std::back_inserter( u16 ) );
   return u16;
 }
 
@@ -1202,26 +1218,26 @@ std::vector<unsigned short> String::toUTF16( const std::string& text )
 
 bool String::compare( const String& str ) const
 {
-  return value_.compare( str.value_ ) == 0;
+  return value_->compare( str.value() ) == 0;
 }
 
 bool String::compare( size_t pos1, size_t len1, const String& str ) const
 {
-  auto itr1 = value_.cbegin();
+  auto itr1 = value_->cbegin();
   pos1 = getBytePosition( &itr1, pos1 );
   len1 = getBytePosition( &itr1, len1 ) - pos1;
-  return value_.compare( pos1, len1, str.value_ ) == 0;
+  return value_->compare( pos1, len1, str.value() ) == 0;
 }
 
 bool String::compare( size_t pos1, size_t len1, const String& str, size_t pos2, size_t len2 ) const
 {
-  auto itr1 = value_.cbegin();
+  auto itr1 = value_->cbegin();
   pos1 = getBytePosition( &itr1, pos1 );
   len1 = getBytePosition( &itr1, len1 ) - pos1;
-  auto itr2 = str.value_.cbegin();
+  auto itr2 = str.value().cbegin();
   pos2 = str.getBytePosition( &itr2, pos2 );
   len2 = str.getBytePosition( &itr2, len2 ) - pos2;
-  return value_.compare( pos1, len1, str.value_, pos2, len2 ) == 0;
+  return value_->compare( pos1, len1, str.value(), pos2, len2 ) == 0;
 }
 
 String* String::fromUCArray( ObjArray* array, bool break_first_null )
@@ -451,6 +451,14 @@ void Token::printOn( std::ostream& os ) const
   case INS_SKIPIFTRUE_ELSE_CONSUME:
     os << "peek at top of stack; skip " << lval << " instructions if true, otherwise consume it";
     break;
+  case INS_LOCAL_LONG_COMPARE_JMPIFFALSE:
+  case INS_LOCAL_LOCAL_COMPARE_JMPIFFALSE:
+    os << "local #" << lval << "; superinstruction: compare, if false goto";
+    break;
+  case INS_LOCAL_LONG_ARITH_ASSIGN:
+  case INS_LOCAL_LOCAL_ARITH_ASSIGN:
+    os << "local #" << lval << "; superinstruction: arithmetic, assign local";
+    break;
   case RSV_COLON:
     os << "':'";
     break;
@@ -219,6 +219,13 @@ enum BTokenId : u16
   INS_SET_MEMBER_ID_UNMINUSMINUS_POST = 0x69,
   INS_SKIPIFTRUE_ELSE_CONSUME = 0x6a,
 
+  // superinstructions, see SuperinstructionOptimizer. They replace the first instruction of the
+  // fused sequence, the remaining instructions stay in place and are skipped when executed.
+  INS_LOCAL_LONG_COMPARE_JMPIFFALSE = 0x6b,   // localvar, long, <comparison>, jmpiffalse
+  INS_LOCAL_LOCAL_COMPARE_JMPIFFALSE = 0x6c,  // localvar, localvar, <comparison>, jmpiffalse
+  INS_LOCAL_LONG_ARITH_ASSIGN = 0x6d,         // localvar, long, + - *, assign localvar
+  INS_LOCAL_LOCAL_ARITH_ASSIGN = 0x6e,        // localvar, localvar, + - *, assign localvar
+
   // --- UPPER SPACE 0x0100-0xFFFF: TOKENS THAT AREN'T PART OF EMITTED CODE ---
   //
   // these can be safely renumbered any time, but must start from 0x100
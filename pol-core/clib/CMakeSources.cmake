@@ -54,6 +54,9 @@ set (clib_sources
   mlog.h
   network/sckutil.cpp 
   network/sckutil.h
+  network/multipoller.h
+  network/multipollers/multipollingwithpoll.h
+  network/multipollers/pollingwithepoll.h
   network/singlepoller.h
   network/singlepollers/pollingwithpoll.h
   network/singlepollers/pollingwithselect.h
@@ -83,6 +86,7 @@ set (clib_sources
   threadhelp.h
   timer.cpp
   timer.h
+  timerwheel.h
   tracebuf.cpp
   tracebuf.h
   unittest.h
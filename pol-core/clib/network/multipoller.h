@@ -0,0 +1,57 @@
+#pragma once
+#ifndef H_MULTIPOLLER
+#define H_MULTIPOLLER
+
+#include "sockets.h"
+
+#include "multipollers/multipollingwithpoll.h"
+#include "multipollers/pollingwithepoll.h"
+
+namespace Pol
+{
+namespace Clib
+{
+#ifdef _WIN32
+using MultiPollingStrategy = MultiPollingWithPoll;
+#else
+using MultiPollingStrategy = PollingWithEpoll;
+#endif
+
+// Waits for events on many sockets at once. Each socket is registered with a user pointer, which is
+// reported back for every socket with pending events.
+// add/modify/remove may be called from other threads than the waiting one.
+class MultiPoller
+{
+public:
+  MultiPoller() : poller(){};
+
+  bool valid() const { return poller.valid(); }
+
+  bool add( SOCKET socket, void* data, bool notify_writable = false )
+  {
+    return poller.add( socket, data, notify_writable );
+  }
+  // without notify_readable incoming data stays in the socket until reading gets enabled again
+  bool modify( SOCKET socket, void* data, bool notify_writable, bool notify_readable = true )
+  {
+    return poller.modify( socket, data, notify_writable, notify_readable );
+  }
+  // socket may already be closed (INVALID_SOCKET), data identifies the registration
+  void remove( SOCKET socket, void* data ) { poller.remove( socket, data ); }
+
+  // returns the number of sockets with events, 0 on timeout or <0 on error
+  int wait_for_events( int timeout_ms ) { return poller.wait_for_events( timeout_ms ); }
+
+  int count() const { return poller.count(); }
+  void* data( int i ) const { return poller.data( i ); }
+  bool incoming( int i ) const { return poller.incoming( i ); }
+  bool error( int i ) const { return poller.error( i ); }
+  bool writable( int i ) const { return poller.writable( i ); }
+
+private:
+  MultiPollingStrategy poller;
+};
+}  // namespace Clib
+}  // namespace Pol
+
+#endif
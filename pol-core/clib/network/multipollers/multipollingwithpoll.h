@@ -0,0 +1,114 @@
+#pragma once
+#ifndef H_MULTIPOLLINGWITHPOLL
+#define H_MULTIPOLLINGWITHPOLL
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../singlepollers/pollingwithpoll.h"
+
+namespace Pol
+{
+namespace Clib
+{
+// Fallback for systems without epoll (Windows): polls a copy of the registered sockets, so
+// changes from other threads get active with the next wait.
+class MultiPollingWithPoll
+{
+public:
+  MultiPollingWithPoll() : _mutex(), _fds(), _data(), _ready() {}
+  MultiPollingWithPoll( const MultiPollingWithPoll& ) = delete;
+  MultiPollingWithPoll& operator=( const MultiPollingWithPoll& ) = delete;
+
+  bool valid() const { return true; }
+
+  bool add( SOCKET socket, void* data, bool notify_writable )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    pollfd fd;
+    fd.fd = socket;
+    fd.events = POLLIN | ( notify_writable ? POLLOUT : 0 );
+    fd.revents = 0;
+    _fds.push_back( fd );
+    _data.push_back( data );
+    return true;
+  }
+  bool modify( SOCKET /*socket*/, void* data, bool notify_writable, bool notify_readable )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    for ( size_t i = 0; i < _fds.size(); ++i )
+    {
+      if ( _data[i] != data )
+        continue;
+      _fds[i].events = ( notify_readable ? POLLIN : 0 ) | ( notify_writable ? POLLOUT : 0 );
+      return true;
+    }
+    return false;
+  }
+  void remove( SOCKET /*socket*/, void* data )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    for ( size_t i = 0; i < _fds.size(); ++i )
+    {
+      if ( _data[i] != data )
+        continue;
+      _fds[i] = _fds.back();
+      _fds.pop_back();
+      _data[i] = _data.back();
+      _data.pop_back();
+      return;
+    }
+  }
+
+  int wait_for_events( int timeout_ms )
+  {
+    std::vector<pollfd> fds;
+    std::vector<void*> data;
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+      fds = _fds;
+      data = _data;
+    }
+    _ready.clear();
+    if ( fds.empty() )
+    {
+      std::this_thread::sleep_for( std::chrono::milliseconds( timeout_ms ) );
+      return 0;
+    }
+    int res = poll( fds.data(), static_cast<unsigned long>( fds.size() ), timeout_ms );
+    if ( res <= 0 )
+      return res;
+    for ( size_t i = 0; i < fds.size(); ++i )
+    {
+      if ( fds[i].revents != 0 )
+        _ready.push_back( Event{data[i], fds[i].revents} );
+    }
+    return static_cast<int>( _ready.size() );
+  }
+
+  int count() const { return static_cast<int>( _ready.size() ); }
+  void* data( int i ) const { return _ready[i].data; }
+  bool incoming( int i ) const { return ( _ready[i].revents & POLLIN ) != 0; }
+  bool writable( int i ) const { return ( _ready[i].revents & POLLOUT ) != 0; }
+  bool error( int i ) const
+  {
+    return ( _ready[i].revents & ( POLLHUP | POLLERR | POLLNVAL ) ) != 0;
+  }
+
+private:
+  struct Event
+  {
+    void* data;
+    short revents;
+  };
+  std::mutex _mutex;
+  std::vector<pollfd> _fds;
+  std::vector<void*> _data;
+  std::vector<Event> _ready;
+};
+}  // namespace Clib
+}  // namespace Pol
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef H_POLLINGWITHEPOLL
+#define H_POLLINGWITHEPOLL
+
+#ifndef _WIN32
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "../sockets.h"
+
+namespace Pol
+{
+namespace Clib
+{
+class PollingWithEpoll
+{
+public:
+  PollingWithEpoll() : epfd( epoll_create1( EPOLL_CLOEXEC ) ), nevents( 0 ) {}
+  ~PollingWithEpoll()
+  {
+    if ( epfd >= 0 )
+      ::close( epfd );
+  }
+  PollingWithEpoll( const PollingWithEpoll& ) = delete;
+  PollingWithEpoll& operator=( const PollingWithEpoll& ) = delete;
+
+  bool valid() const { return epfd >= 0; }
+
+  bool add( SOCKET socket, void* data, bool notify_writable )
+  {
+    epoll_event ev = make_event( data, notify_writable, true );
+    return epoll_ctl( epfd, EPOLL_CTL_ADD, socket, &ev ) == 0;
+  }
+  bool modify( SOCKET socket, void* data, bool notify_writable, bool notify_readable )
+  {
+    epoll_event ev = make_event( data, notify_writable, notify_readable );
+    return epoll_ctl( epfd, EPOLL_CTL_MOD, socket, &ev ) == 0;
+  }
+  void remove( SOCKET socket, void* /*data*/ )
+  {
+    // a closed socket is already gone from the set and its number might be in use again
+    if ( socket == INVALID_SOCKET )
+      return;
+    epoll_event ev{};  // ignored, but needed by older kernels
+    epoll_ctl( epfd, EPOLL_CTL_DEL, socket, &ev );
+  }
+
+  int wait_for_events( int timeout_ms )
+  {
+    int res = epoll_wait( epfd, events, MAX_EVENTS, timeout_ms );
+    nevents = res > 0 ? res : 0;
+    return res;
+  }
+
+  int count() const { return nevents; }
+  void* data( int i ) const { return events[i].data.ptr; }
+  bool incoming( int i ) const { return ( events[i].events & EPOLLIN ) != 0; }
+  bool writable( int i ) const { return ( events[i].events & EPOLLOUT ) != 0; }
+  bool error( int i ) const { return ( events[i].events & ( EPOLLERR | EPOLLHUP ) ) != 0; }
+
+private:
+  static epoll_event make_event( void* data, bool notify_writable, bool notify_readable )
+  {
+    epoll_event ev{};  // level triggered, errors are always reported
+    if ( notify_readable )
+      ev.events |= EPOLLIN;
+    if ( notify_writable )
+      ev.events |= EPOLLOUT;
+    ev.data.ptr = data;
+    return ev;
+  }
+
+  static const int MAX_EVENTS = 256;
+  int epfd;
+  epoll_event events[MAX_EVENTS];
+  int nevents;
+};
+}  // namespace Clib
+}  // namespace Pol
+
+#endif
+#endif
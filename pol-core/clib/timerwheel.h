@@ -0,0 +1,342 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef CLIB_TIMERWHEEL_H
+#define CLIB_TIMERWHEEL_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "rawtypes.h"
+
+namespace Pol
+{
+namespace Clib
+{
+/**
+ * Hierarchical timer wheel: inserting, erasing and expiring an entry is O(1).
+ *
+ * Time is counted in integer ticks. Level 0 has one slot per tick for the next 64 ticks, each
+ * further level covers 64 times the range of the one below with one slot per 64^level ticks.
+ * When the time reaches a slot of a higher level, its entries get distributed to the lower
+ * levels. Entries beyond the last level wait in an overflow list.
+ *
+ * advance() moves the expired entries into a due list, where they stay until they get erased,
+ * so erase() works the same for pending and expired entries.
+ * Entries are kept in a node pool and addressed by index, a Handle stays valid until the entry
+ * gets erased.
+ */
+template <typename T>
+class TimerWheel
+{
+public:
+  typedef s64 Tick;
+  typedef u32 Handle;
+  typedef std::pair<Tick, T> value_type;
+
+private:
+  static const unsigned SLOT_BITS = 6;
+  static const unsigned SLOTS = 1u << SLOT_BITS;
+  static const unsigned LEVELS = 4;
+  static const unsigned OVERFLOW_LIST = LEVELS * SLOTS;
+  static const unsigned DUE_LIST = OVERFLOW_LIST + 1;
+  static const unsigned LIST_COUNT = DUE_LIST + 1;
+  static const u16 NO_LIST = 0xFFFF;
+  static const u32 NIL = ~0u;
+
+  struct Node
+  {
+    value_type entry;
+    u32 prev;
+    u32 next;
+    u16 list;
+  };
+
+public:
+  class const_iterator
+  {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename TimerWheel::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    const_iterator( const std::vector<Node>* nodes, size_t index ) : nodes_( nodes ), index_( index )
+    {
+      skip_unused();
+    }
+    reference operator*() const { return ( *nodes_ )[index_].entry; }
+    pointer operator->() const { return &( *nodes_ )[index_].entry; }
+    const_iterator& operator++()
+    {
+      ++index_;
+      skip_unused();
+      return *this;
+    }
+    bool operator==( const const_iterator& other ) const { return index_ == other.index_; }
+    bool operator!=( const const_iterator& other ) const { return index_ != other.index_; }
+
+  private:
+    void skip_unused()
+    {
+      while ( index_ < nodes_->size() && ( *nodes_ )[index_].list == NO_LIST )
+        ++index_;
+    }
+    const std::vector<Node>* nodes_;
+    size_t index_;
+  };
+
+  explicit TimerWheel( Tick now = 0 ) : nodes_(), free_( NIL ), now_( now ), size_( 0 )
+  {
+    for ( unsigned list = 0; list < LIST_COUNT; ++list )
+      heads_[list] = tails_[list] = NIL;
+    for ( auto& bits : occupied_ )
+      bits = 0;
+  }
+
+  Handle insert( Tick expiry, const T& value )
+  {
+    u32 index;
+    if ( free_ != NIL )
+    {
+      index = free_;
+      free_ = nodes_[index].next;
+    }
+    else
+    {
+      index = static_cast<u32>( nodes_.size() );
+      nodes_.push_back( Node() );
+    }
+    nodes_[index].entry = value_type( expiry, value );
+    place( index );
+    ++size_;
+    return index;
+  }
+
+  void erase( Handle handle )
+  {
+    unlink( handle );
+    Node& node = nodes_[handle];
+    node.entry.second = T();
+    node.list = NO_LIST;
+    node.next = free_;
+    free_ = handle;
+    --size_;
+  }
+
+  void clear()
+  {
+    nodes_.clear();
+    for ( unsigned list = 0; list < LIST_COUNT; ++list )
+      heads_[list] = tails_[list] = NIL;
+    for ( auto& bits : occupied_ )
+      bits = 0;
+    free_ = NIL;
+    size_ = 0;
+  }
+
+  // moves every entry with an expiry <= now into the due list
+  void advance( Tick now )
+  {
+    while ( now_ < now )
+    {
+      if ( occupied_[0] == 0 )
+      {
+        if ( heads_[OVERFLOW_LIST] == NIL && !occupied_higher_levels() )
+        {
+          now_ = now;
+          break;
+        }
+        // nothing to expire until the next level 0 round, but it might need a cascade
+        Tick round_end = now_ | ( SLOTS - 1 );
+        if ( round_end >= now )
+        {
+          now_ = now;
+          break;
+        }
+        now_ = round_end;
+      }
+      ++now_;
+      unsigned slot = static_cast<unsigned>( now_ & ( SLOTS - 1 ) );
+      if ( slot == 0 )
+        cascade();
+      if ( occupied_[0] & ( u64( 1 ) << slot ) )
+        move_list( slot, DUE_LIST );
+    }
+  }
+
+  // an expired entry or nullptr, the entry stays due until it gets erased
+  const value_type* due() const
+  {
+    if ( heads_[DUE_LIST] == NIL )
+      return nullptr;
+    return &nodes_[heads_[DUE_LIST]].entry;
+  }
+  Handle due_handle() const { return heads_[DUE_LIST]; }
+
+  // no entry which isn't due yet expires before the returned tick
+  Tick next_expiry_bound() const
+  {
+    if ( heads_[DUE_LIST] != NIL )
+      return now_;
+    // entries of the higher levels might expire right after their cascade
+    Tick bound = now_ + ( Tick( 1 ) << ( SLOT_BITS * LEVELS ) );
+    if ( heads_[OVERFLOW_LIST] != NIL || occupied_higher_levels() )
+      bound = ( now_ | ( SLOTS - 1 ) ) + 1;
+    if ( occupied_[0] != 0 )
+    {
+      unsigned start = static_cast<unsigned>( ( now_ + 1 ) & ( SLOTS - 1 ) );
+      u64 bits = occupied_[0];
+      u64 rotated = start ? ( ( bits >> start ) | ( bits << ( SLOTS - start ) ) ) : bits;
+      unsigned offset = 0;
+      while ( !( rotated & 1 ) )
+      {
+        rotated >>= 1;
+        ++offset;
+      }
+      if ( now_ + 1 + offset < bound )
+        bound = now_ + 1 + offset;
+    }
+    return bound;
+  }
+
+  Tick now() const { return now_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  size_t sizeEstimate() const { return sizeof( *this ) + nodes_.capacity() * sizeof( Node ); }
+
+  const_iterator begin() const { return const_iterator( &nodes_, 0 ); }
+  const_iterator end() const { return const_iterator( &nodes_, nodes_.size() ); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+private:
+  bool occupied_higher_levels() const
+  {
+    for ( unsigned level = 1; level < LEVELS; ++level )
+    {
+      if ( occupied_[level] != 0 )
+        return true;
+    }
+    return false;
+  }
+
+  // puts a node into the list matching its expiry
+  void place( u32 index )
+  {
+    Tick expiry = nodes_[index].entry.first;
+    if ( expiry <= now_ )
+    {
+      link( index, DUE_LIST );
+      return;
+    }
+    Tick delta = expiry - now_;
+    for ( unsigned level = 0; level < LEVELS; ++level )
+    {
+      if ( delta < ( Tick( 1 ) << ( SLOT_BITS * ( level + 1 ) ) ) )
+      {
+        unsigned slot = static_cast<unsigned>( ( expiry >> ( SLOT_BITS * level ) ) & ( SLOTS - 1 ) );
+        link( index, level * SLOTS + slot );
+        return;
+      }
+    }
+    link( index, OVERFLOW_LIST );
+  }
+
+  // distributes the slots of the higher levels which start at now_
+  void cascade()
+  {
+    for ( unsigned level = 1; level < LEVELS; ++level )
+    {
+      unsigned slot =
+          static_cast<unsigned>( ( now_ >> ( SLOT_BITS * level ) ) & ( SLOTS - 1 ) );
+      redistribute( level * SLOTS + slot );
+      if ( slot != 0 )
+        return;
+    }
+    redistribute( OVERFLOW_LIST );
+  }
+
+  void redistribute( unsigned list )
+  {
+    u32 index = detach( list );
+    while ( index != NIL )
+    {
+      u32 next = nodes_[index].next;
+      place( index );
+      index = next;
+    }
+  }
+
+  void move_list( unsigned from, unsigned to )
+  {
+    u32 index = detach( from );
+    while ( index != NIL )
+    {
+      u32 next = nodes_[index].next;
+      link( index, to );
+      index = next;
+    }
+  }
+
+  // empties a list, returns its former head, the nodes stay chained by next
+  u32 detach( unsigned list )
+  {
+    u32 head = heads_[list];
+    heads_[list] = tails_[list] = NIL;
+    if ( list < OVERFLOW_LIST )
+      occupied_[list / SLOTS] &= ~( u64( 1 ) << ( list % SLOTS ) );
+    return head;
+  }
+
+  // appends, so entries of the same tick expire in insertion order
+  void link( u32 index, unsigned list )
+  {
+    Node& node = nodes_[index];
+    node.list = static_cast<u16>( list );
+    node.prev = tails_[list];
+    node.next = NIL;
+    if ( node.prev != NIL )
+      nodes_[node.prev].next = index;
+    else
+      heads_[list] = index;
+    tails_[list] = index;
+    if ( list < OVERFLOW_LIST )
+      occupied_[list / SLOTS] |= u64( 1 ) << ( list % SLOTS );
+  }
+
+  void unlink( u32 index )
+  {
+    Node& node = nodes_[index];
+    if ( node.prev != NIL )
+      nodes_[node.prev].next = node.next;
+    else
+    {
+      heads_[node.list] = node.next;
+      if ( node.next == NIL && node.list < OVERFLOW_LIST )
+        occupied_[node.list / SLOTS] &= ~( u64( 1 ) << ( node.list % SLOTS ) );
+    }
+    if ( node.next != NIL )
+      nodes_[node.next].prev = node.prev;
+    else
+      tails_[node.list] = node.prev;
+  }
+
+  std::vector<Node> nodes_;
+  u32 heads_[LIST_COUNT];
+  u32 tails_[LIST_COUNT];
+  u64 occupied_[LEVELS];  // one bit per non empty slot
+  u32 free_;              // unused nodes, chained by next
+  Tick now_;              // last tick advance() processed
+  size_t size_;
+};
+}  // namespace Clib
+}  // namespace Pol
+
+#endif
@@ -69,6 +69,8 @@ public:
   weak_ptr_owner( const weak_ptr_owner& ) = delete;
   weak_ptr_owner& operator=( const weak_ptr_owner& ) = delete;
   void set( T* obptr );
+  // detaches the weak_ptrs handed out so far, only new ones point to obptr
+  void renew( T* obptr );
 };
 
 template <class T>
@@ -147,5 +149,12 @@ void weak_ptr_owner<T>::set( T* obptr )
 {
   this->ref_ptr<weak_ptr_link<T>>::get()->set_weakptr( obptr );
 }
+template <class T>
+void weak_ptr_owner<T>::renew( T* obptr )
+{
+  this->ref_ptr<weak_ptr_link<T>>::get()->clear_weakptr();
+  this->ref_ptr<weak_ptr_link<T>>::set( new weak_ptr_link<T> );
+  set( obptr );
+}
 
 #endif  // __WEAKPTR_H
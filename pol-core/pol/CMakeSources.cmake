@@ -234,12 +234,16 @@ set (pol_sources  # sorted !
   network/client.h
   network/clientio.cpp
   network/clientio.h
+  network/clientreactor.cpp
+  network/clientreactor.h
   network/clientthread.cpp
   network/clientthread.h
   network/clienttransmit.cpp
   network/clienttransmit.h
   network/cliface.cpp
   network/cliface.h
+  network/inboundqueue.cpp
+  network/inboundqueue.h
   network/iostats.cpp
   network/iostats.h
   network/msgfiltr.cpp
@@ -265,6 +269,7 @@ set (pol_sources  # sorted !
   network/pktoutid.h
   network/sockio.cpp
   network/sockio.h
+  network/xbuffer.cpp
   network/xbuffer.h
   npctemplates.cpp
   npctmpl.cpp
@@ -382,6 +387,7 @@ set (pol_sources  # sorted !
   testing/testenv.h
   testing/testlos.cpp
   testing/testmisc.cpp
+  testing/testnetwork.cpp
   testing/testskill.cpp
   testing/testwalk.cpp
   textcmd.cpp
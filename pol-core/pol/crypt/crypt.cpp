@@ -1,5 +1,6 @@
 
-#include "../../clib/passert.h"
+#include <string.h>
+
 #include "../../plib/uconst.h"
 #include "blowfish.h"
 #include "crypt.h"
@@ -15,9 +16,10 @@ namespace Crypt
 {
 CCryptNoCrypt::CCryptNoCrypt() : CCryptBase() {}
 
-int CCryptNoCrypt::Receive( void* buffer, int max_expected, SOCKET socket )
+void CCryptNoCrypt::Decrypt( void* pvIn, void* pvOut, int len )
 {
-  return recv( socket, (char*)buffer, max_expected, 0 );
+  if ( pvIn != pvOut )
+    memmove( pvOut, pvIn, len );
 }
 
 void CCryptNoCrypt::Init( void* pvSeed, int type )
@@ -36,19 +38,6 @@ CCryptBlowfish::CCryptBlowfish( unsigned int masterKey1, unsigned int masterKey2
   SetMasterKeys( masterKey1, masterKey2 );
 }
 
-int CCryptBlowfish::Receive( void* buffer, int max_expected, SOCKET socket )
-{
-  passert_always( max_expected >= 0 );
-  passert_always( MAXBUFFER > max_expected );
-  int count = recv( socket, (char*)encrypted_data, max_expected, 0 );
-  if ( count > 0 )
-  {
-    passert( count <= max_expected );
-    Decrypt( encrypted_data, buffer, count );
-  }
-  return count;
-}
-
 void CCryptBlowfish::Init( void* pvSeed, int type )
 {
   unsigned char* pSeed = (unsigned char*)pvSeed;
@@ -155,19 +144,6 @@ CCryptBlowfishTwofish::CCryptBlowfishTwofish( unsigned int masterKey1, unsigned
   SetMasterKeys( masterKey1, masterKey2 );
 }
 
-int CCryptBlowfishTwofish::Receive( void* buffer, int max_expected, SOCKET socket )
-{
-  passert_always( max_expected >= 0 );
-  passert_always( MAXBUFFER > max_expected );
-  int count = recv( socket, (char*)encrypted_data, max_expected, 0 );
-  if ( count > 0 )
-  {
-    passert( count <= max_expected );
-    Decrypt( encrypted_data, buffer, count );
-  }
-  return count;
-}
-
 void CCryptBlowfishTwofish::Init( void* pvSeed, int type )
 {
   unsigned char* pSeed = (unsigned char*)pvSeed;
@@ -212,19 +188,6 @@ CCryptTwofish::CCryptTwofish( unsigned int masterKey1, unsigned int masterKey2 )
   SetMasterKeys( masterKey1, masterKey2 );
 }
 
-int CCryptTwofish::Receive( void* buffer, int max_expected, SOCKET socket )
-{
-  passert_always( max_expected >= 0 );
-  passert_always( MAXBUFFER > max_expected );
-  int count = recv( socket, (char*)encrypted_data, max_expected, 0 );
-  if ( count > 0 )
-  {
-    passert( count <= max_expected );
-    Decrypt( encrypted_data, buffer, count );
-  }
-  return count;
-}
-
 void CCryptTwofish::Init( void* pvSeed, int type )
 {
   unsigned char* pSeed = (unsigned char*)pvSeed;
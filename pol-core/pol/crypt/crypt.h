@@ -29,8 +29,8 @@ public:
 
   // Member Functions
 public:
-  virtual int Receive( void* buffer, int max_expected, SOCKET socket ) override;
   virtual void Init( void* pvSeed, int type = CCryptBase::typeAuto ) override;
+  virtual void Decrypt( void* pvIn, void* pvOut, int len ) override;
 };
 
 // BLOWFISH
@@ -49,7 +49,6 @@ public:
 
   // Member Functions
 public:
-  virtual int Receive( void* buffer, int max_expected, SOCKET socket ) override;
   virtual void Init( void* pvSeed, int type = CCryptBase::typeAuto ) override;
 
 protected:
@@ -97,7 +96,6 @@ public:
   TwoFish tfish;
 
 public:
-  virtual int Receive( void* buffer, int max_expected, SOCKET socket ) override;
   virtual void Init( void* pvSeed, int type = CCryptBase::typeAuto ) override;
 
 protected:
@@ -117,7 +115,6 @@ public:
   MD5Crypt md5;
 
 public:
-  virtual int Receive( void* buffer, int max_expected, SOCKET socket ) override;
   virtual void Init( void* pvSeed, int type = CCryptBase::typeAuto ) override;
   virtual void Encrypt( void* pvIn, void* pvOut, int len ) override;
 
@@ -74,7 +74,6 @@ namespace Crypt
 CCryptBaseCrypt::CCryptBaseCrypt() : CCryptBase(), lcrypt(), m_type( 0 )
 {
   memset( &m_masterKey, 0, sizeof( m_masterKey ) );
-  memset( &encrypted_data, 0, sizeof( encrypted_data ) );
 }
 
 void CCryptBaseCrypt::SetMasterKeys( unsigned int masterKey1, unsigned int masterKey2 )
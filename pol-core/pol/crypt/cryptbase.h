@@ -95,8 +95,9 @@ public:
 
   // Member Functions
 public:
-  virtual int Receive( void* buffer, int max_expected, SOCKET socket ) = 0;
   virtual void Init( void* pvSeed, int type = typeAuto ) = 0;
+  // decrypts the next len bytes of the client stream, pvIn and pvOut may be the same
+  virtual void Decrypt( void* pvIn, void* pvOut, int len ) = 0;
   virtual void Encrypt( void* pvIn, void* pvOut, int len )
   {
     /* Do nothing. */
@@ -121,12 +122,10 @@ public:
 protected:
   int m_type;
   unsigned int m_masterKey[2];
-  unsigned char encrypted_data[MAXBUFFER];
 
   // Member Functions
 protected:
   void SetMasterKeys( unsigned int masterKey1, unsigned int masterKey2 );
-  virtual void Decrypt( void* pvIn, void* pvOut, int len ) = 0;
 };
 }  // namespace Crypt
 }  // namespace Pol
@@ -6,6 +6,8 @@
 
 #include "ctable.h"
 
+#include "../clib/rawtypes.h"
+
 namespace Pol
 {
 namespace Core
@@ -77,5 +79,104 @@ SVR_KEYDESC keydesc[257] = {
     {9, 0x0167, 0x01cd},  {10, 0x0210, 0x0021}, {10, 0x023a, 0x0171}, {10, 0x01b8, 0x0076},
     {11, 0x03af, 0x07ae}, {10, 0x018e, 0x01c6}, {10, 0x02ec, 0x00dd}, {7, 0x0062, 0x0023},
     {4, 0x000d, 0x000b}};
+
+/* keydesc[].bits holds the code MSB first, so whole codes can be shifted into an accumulator.
+   Codes are at most 11 bits long, flushing 32 bits at a time keeps at most 42 bits pending.
+   Stale bits above the pending ones are never masked, they simply get shifted out.
+   Produces the same output as emitting bits_reversed bit by bit (LSB first).
+   */
+size_t huffman_compress( const unsigned char* data, size_t len, unsigned char* out,
+                         size_t outsize )
+{
+  unsigned char* pch = out;
+  unsigned char* const end = out + outsize;
+  u64 acc = 0;
+  unsigned int pending = 0;
+
+  auto append = [&]( const SVR_KEYDESC& key ) -> bool {
+    acc = ( acc << key.nbits ) | key.bits;
+    pending += key.nbits;
+    if ( pending >= 32 )
+    {
+      if ( end - pch < 4 )
+        return false;
+      pending -= 32;
+      u32 word = static_cast<u32>( acc >> pending );
+      pch[0] = static_cast<unsigned char>( word >> 24 );
+      pch[1] = static_cast<unsigned char>( word >> 16 );
+      pch[2] = static_cast<unsigned char>( word >> 8 );
+      pch[3] = static_cast<unsigned char>( word );
+      pch += 4;
+    }
+    return true;
+  };
+
+  for ( size_t i = 0; i < len; ++i )
+  {
+    if ( !append( keydesc[data[i]] ) )
+      return 0;
+  }
+  if ( !append( keydesc[0x100] ) || static_cast<unsigned int>( end - pch ) < ( pending + 7 ) / 8 )
+    return 0;
+
+  while ( pending >= 8 )
+  {
+    pending -= 8;
+    *pch++ = static_cast<unsigned char>( acc >> pending );
+  }
+  if ( pending )
+    *pch++ = static_cast<unsigned char>( acc << ( 8 - pending ) );
+
+  return pch - out;
+}
+
+namespace
+{
+const unsigned int MAX_CODE_BITS = 11;
+
+// symbol of every code, indexed by ( 1 << nbits ) | bits, -1 if there is none
+const std::vector<short>& huffman_decode_table()
+{
+  static const std::vector<short> table = []() {
+    std::vector<short> t( 2u << MAX_CODE_BITS, -1 );
+    for ( short i = 0; i < 257; ++i )
+      t[( 1u << keydesc[i].nbits ) | keydesc[i].bits] = i;
+    return t;
+  }();
+  return table;
+}
+}  // namespace
+
+HuffmanDecoder::HuffmanDecoder() : _packet(), _code( 0 ), _nbits( 0 ) {}
+
+bool HuffmanDecoder::decode( const unsigned char* data, size_t len,
+                             std::vector<std::vector<unsigned char>>* packets )
+{
+  const std::vector<short>& table = huffman_decode_table();
+  for ( size_t i = 0; i < len; ++i )
+  {
+    for ( int bit = 7; bit >= 0; --bit )
+    {
+      _code = ( _code << 1 ) | ( ( data[i] >> bit ) & 1 );
+      if ( ++_nbits > MAX_CODE_BITS )
+        return false;
+      short symbol = table[( 1u << _nbits ) | _code];
+      if ( symbol < 0 )
+        continue;
+      _code = 0;
+      _nbits = 0;
+      if ( symbol != 0x100 )
+      {
+        _packet.push_back( static_cast<unsigned char>( symbol ) );
+        continue;
+      }
+      // terminator, the rest of the byte is padding
+      packets->push_back( std::move( _packet ) );
+      _packet.clear();
+      break;
+    }
+  }
+  return true;
+}
+}
 }
-}
\ No newline at end of file
@@ -5,6 +5,10 @@
 
 #ifndef __CTABLE_H
 #define __CTABLE_H
+
+#include <cstddef>
+#include <vector>
+
 namespace Pol
 {
 namespace Core
@@ -18,6 +22,28 @@ struct SVR_KEYDESC
 
 // last one is a terminator
 extern SVR_KEYDESC keydesc[257];
+
+// compresses data including the terminator code into out,
+// returns the number of bytes written or 0 if outsize was too small
+size_t huffman_compress( const unsigned char* data, size_t len, unsigned char* out,
+                         size_t outsize );
+
+// decodes the compressed stream like a client does, every packet ends with the terminator code and
+// is padded to full bytes. Keeps its state between calls, so the stream can be fed in pieces.
+class HuffmanDecoder
+{
+public:
+  HuffmanDecoder();
+
+  // appends every completed packet, returns false if the data contains an invalid code
+  bool decode( const unsigned char* data, size_t len,
+               std::vector<std::vector<unsigned char>>* packets );
+
+private:
+  std::vector<unsigned char> _packet;
+  unsigned int _code;
+  unsigned int _nbits;
+};
 }
 }
 #endif
@@ -104,7 +104,7 @@ void decay_worldzone( unsigned wx, unsigned wy, Realms::Realm* realm )
 
       item->spill_contents( multi );
       destroy_item( item );
-      --idx;
+      --idx;  // the last item of the zone took its place
     }
   }
 }
@@ -10,8 +10,10 @@
 #include "../accounts/account.h"
 #include "../mobile/charactr.h"
 #include "../network/auxclient.h"
+#include "../network/clientreactor.h"
 #include "../network/clienttransmit.h"
 #include "../network/cliface.h"
+#include "../network/inboundqueue.h"
 #include "../network/msgfiltr.h"
 #include "../network/msghandl.h"
 #include "../network/packethooks.h"
@@ -41,6 +43,7 @@ NetworkManager::NetworkManager()
       uoclient_listeners(),
       iostats(),
       queuedmode_iostats(),
+      packet_timings(),
       login_filter( nullptr ),
       game_filter( nullptr ),
       disconnected_filter( nullptr ),
@@ -51,6 +54,8 @@ NetworkManager::NetworkManager()
       ext_handler_table(),
       packetsSingleton( new Network::PacketsSingleton() ),
       clientTransmit( new Network::ClientTransmit() ),
+      clientReactor(),
+      inboundQueue(),
       auxthreadpool( new threadhelp::DynTaskThreadPool( "AuxPool" ) ),  // TODO: seems to work
                                                                         // activate by default?
                                                                         // maybe add a cfg entry for
@@ -99,6 +104,8 @@ void NetworkManager::kill_disconnected_clients()
 
 void NetworkManager::deinialize()
 {
+  clientReactor.reset();
+  inboundQueue.reset();
   for ( auto& client : clients )
   {
     client->forceDisconnect();
@@ -20,7 +20,9 @@ namespace Network
 {
 class AuxService;
 class Client;
+class ClientReactor;
 class ClientTransmit;
+class InboundQueue;
 class PacketHookData;
 class PacketsSingleton;
 class UOClientInterface;
@@ -72,6 +74,7 @@ public:
 
   Network::IOStats iostats;
   Network::IOStats queuedmode_iostats;
+  Network::PacketTimings packet_timings;
   std::unique_ptr<MessageTypeFilter> login_filter;
   std::unique_ptr<MessageTypeFilter> game_filter;
   std::unique_ptr<MessageTypeFilter> disconnected_filter;
@@ -97,6 +100,8 @@ public:
   std::unique_ptr<Network::PacketsSingleton> packetsSingleton;
 
   std::unique_ptr<Network::ClientTransmit> clientTransmit;
+  std::unique_ptr<Network::ClientReactor> clientReactor;  // only with NetworkReactorThreads
+  std::unique_ptr<Network::InboundQueue> inboundQueue;    // only with QueueInboundMessages
 
   std::unique_ptr<threadhelp::DynTaskThreadPool> auxthreadpool;
 
@@ -7,6 +7,7 @@
 #include "../../clib/stlutil.h"
 #include "../../plib/systemstate.h"
 #include "../polsig.h"
+#include "../scrsched.h"
 #include "../uoexec.h"
 #include "state.h"
 
@@ -31,7 +32,9 @@ ScriptScheduler::ScriptScheduler()
       notimeoutholdlist(),
       debuggerholdlist(),
       pidlist(),
-      next_pid( PID_MIN )
+      next_pid( PID_MIN ),
+      executor_pool(),
+      executor_pool_stats_()
 {
 }
 
@@ -45,11 +48,9 @@ void ScriptScheduler::deinitialize()
 {
   scrstore.clear();
   Clib::delete_all( runlist );
-  while ( !holdlist.empty() )
-  {
-    delete ( ( *holdlist.begin() ).second );
-    holdlist.erase( holdlist.begin() );
-  }
+  for ( const auto& hold : holdlist )
+    delete hold.second;
+  holdlist.clear();
   while ( !notimeoutholdlist.empty() )
   {
     delete ( *notimeoutholdlist.begin() );
@@ -60,6 +61,7 @@ void ScriptScheduler::deinitialize()
     delete ( *debuggerholdlist.begin() );
     debuggerholdlist.erase( debuggerholdlist.begin() );
   }
+  Clib::delete_all( executor_pool );
 }
 
 ScriptScheduler::Memory ScriptScheduler::estimateSize( bool verbose ) const
@@ -123,8 +125,8 @@ ScriptScheduler::Memory ScriptScheduler::estimateSize( bool verbose ) const
       if ( verbose )
         verbose_w << hold.second->scriptname() << " " << hold.second->sizeEstimate() << "\n";
     }
-    usage.script_size += sizeof( Core::polclock_t ) + ( sizeof( void* ) * 3 + 1 ) / 2;
   }
+  usage.script_size += holdlist.sizeEstimate();
   usage.script_count += holdlist.size();
 
   usage.script_size += 3 * sizeof( void* );
@@ -154,6 +156,10 @@ ScriptScheduler::Memory ScriptScheduler::estimateSize( bool verbose ) const
     }
   }
   usage.script_count += debuggerholdlist.size();
+
+  usage.script_size += 3 * sizeof( UOExecutor** );
+  for ( const auto& exec : executor_pool )
+    usage.script_size += exec->sizeEstimate() + sizeof( UOExecutor* );
   if ( verbose )
   {
     auto log = OPEN_FLEXLOG( "log/memoryusagescripts.log", false );
@@ -188,10 +194,16 @@ void ScriptScheduler::run_ready()
 
     while ( ex->runnable() )
     {
-      ++ex->instr_cycles;
+      // critical scripts run in chunks to still report long runs
+      unsigned int batch = ex->critical() ? 1000 - inscount + 1 : insleft;
+      // stop exactly at the next runaway check
+      if ( ex->warn_runaway_on_cycle > ex->instr_cycles &&
+           ex->warn_runaway_on_cycle - ex->instr_cycles < batch )
+        batch = static_cast<unsigned int>( ex->warn_runaway_on_cycle - ex->instr_cycles );
       THREAD_CHECKPOINT( scripts, 112 );
       Clib::scripts_thread_scriptPC = ex->PC;
-      ex->execInstr();
+      unsigned int executed = ex->execInstrs( batch );
+      ex->instr_cycles += executed;
 
       THREAD_CHECKPOINT( scripts, 113 );
 
@@ -219,8 +231,8 @@ void ScriptScheduler::run_ready()
 
       if ( ex->critical() )
       {
-        ++inscount;
-        ++totcount;
+        inscount += executed;
+        totcount += executed;
         if ( inscount > 1000 )
         {
           inscount = 0;
@@ -236,7 +248,8 @@ void ScriptScheduler::run_ready()
         continue;
       }
 
-      if ( !--insleft )
+      insleft -= executed;
+      if ( insleft <= 0 )
       {
         break;
       }
@@ -288,7 +301,7 @@ void ScriptScheduler::run_ready()
       if ( ex->sleep_until_clock() )
       {
         ex->in_hold_list( Core::HoldListType::TIMEOUT_LIST );
-        ex->hold_itr( holdlist.insert( HoldList::value_type( ex->sleep_until_clock(), ex ) ) );
+        ex->hold_itr( holdlist.insert( ex->sleep_until_clock(), ex ) );
       }
       else
       {
@@ -320,6 +333,33 @@ void ScriptScheduler::schedule( UOExecutor* exec )
   enqueue( exec );
 }
 
+UOExecutor* ScriptScheduler::acquire_executor()
+{
+  if ( executor_pool.empty() )
+  {
+    ++executor_pool_stats_.created;
+    return create_full_script_executor();
+  }
+  UOExecutor* exec = executor_pool.back();
+  executor_pool.pop_back();
+  exec->restart();
+  ++executor_pool_stats_.reused;
+  return exec;
+}
+
+void ScriptScheduler::release_executor( UOExecutor* exec )
+{
+  // run to completion scripts rarely nest deeper than this
+  static const size_t MAX_POOLED_EXECUTORS = 16;
+  if ( executor_pool.size() >= MAX_POOLED_EXECUTORS )
+  {
+    delete exec;
+    return;
+  }
+  exec->reset();
+  executor_pool.push_back( exec );
+}
+
 unsigned int ScriptScheduler::get_new_pid( UOExecutor* exec )
 {
   for ( ;; )
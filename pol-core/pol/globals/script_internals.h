@@ -4,9 +4,13 @@
 #include <deque>
 #include <map>
 #include <set>
+#include <unordered_set>
+#include <vector>
 
 #include "../../bscript/eprog.h"
 #include "../../clib/maputil.h"
+#include "../../clib/rawtypes.h"
+#include "../../clib/timerwheel.h"
 #include "../polclock.h"
 #include "../reftypes.h"
 
@@ -17,11 +21,12 @@ namespace Core
 class UOExecutor;
 
 typedef std::deque<UOExecutor*> ExecList;
-typedef std::set<UOExecutor*> NoTimeoutHoldList;
-typedef std::multimap<Core::polclock_t, Core::UOExecutor*> HoldList;
+typedef std::unordered_set<UOExecutor*> NoTimeoutHoldList;
+// scripts sleeping until a polclock, see check_blocked()
+typedef Clib::TimerWheel<UOExecutor*> HoldList;
 typedef std::map<std::string, ref_ptr<Bscript::EScriptProgram>, Clib::ci_cmp_pred> ScriptStorage;
 typedef std::map<unsigned int, UOExecutor*> PidList;
-typedef HoldList::iterator TimeoutHandle;
+typedef HoldList::Handle TimeoutHandle;
 
 
 enum HoldListType
@@ -72,6 +77,8 @@ public:
   bool logScriptVariables( const std::string& name ) const;
 
   void run_ready();
+  // moves the scripts whose sleep ended until now into the due list of the holdlist
+  void expire_timeouts( polclock_t now );
 
   const ExecList& getRanlist();
   const ExecList& getRunlist();
@@ -91,6 +98,19 @@ public:
   // Sets up the executor before adding to the queue
   void schedule( UOExecutor* exec );
 
+  // Executors for run to completion scripts. Released executors keep their common modules and
+  // get reused by the next script instead of creating all of them again.
+  UOExecutor* acquire_executor();
+  void release_executor( UOExecutor* exec );
+
+  struct ExecutorPoolStats
+  {
+    u64 created;
+    u64 reused;
+  };
+  const ExecutorPoolStats& executor_pool_stats() const;
+  size_t pooled_executors() const;
+
 
   // The following methods should go to a different class,
   // together with the pidlist and new_pid.
@@ -113,6 +133,9 @@ private:
 
   PidList pidlist;
   unsigned int next_pid;
+
+  std::vector<UOExecutor*> executor_pool;
+  ExecutorPoolStats executor_pool_stats_;
 };
 
 const inline ExecList& ScriptScheduler::getRanlist()
@@ -142,6 +165,11 @@ inline void ScriptScheduler::revive_debugged( UOExecutor* exec )
   enqueue( exec );
 }
 
+inline void ScriptScheduler::expire_timeouts( polclock_t now )
+{
+  holdlist.advance( now );
+}
+
 inline void ScriptScheduler::revive_timeout( UOExecutor* exec, TimeoutHandle hold_itr )
 {
   holdlist.erase( hold_itr );
@@ -159,6 +187,16 @@ inline void ScriptScheduler::enqueue( UOExecutor* exec )
   runlist.push_back( exec );
 }
 
+inline const ScriptScheduler::ExecutorPoolStats& ScriptScheduler::executor_pool_stats() const
+{
+  return executor_pool_stats_;
+}
+
+inline size_t ScriptScheduler::pooled_executors() const
+{
+  return executor_pool.size();
+}
+
 inline void ScriptScheduler::free_pid( unsigned int pid )
 {
   pidlist.erase( pid );
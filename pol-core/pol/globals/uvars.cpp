@@ -107,6 +107,8 @@ GameState::GameState()
       write_account_task( new PeriodicTask( Accounts::write_account_data_task, 60, "WRITEACCT" ) ),
       update_sysload_task( new PeriodicTask( update_sysload, 1, "SYSLOAD" ) ),
       reload_pol_cfg_task( new PeriodicTask( PolConfig::reload_pol_cfg, 30, "LOADPOLCFG" ) ),
+      log_packet_timings_task(
+          new PeriodicTask( Network::log_packet_timings, 60, "PKTTIMINGS" ) ),
 
       attributes(),
       numAttributes( 0 ),
@@ -283,6 +285,7 @@ void GameState::cleanup_vars()
           item->destroy();
         }
         realm->zone[wx][wy].items.clear();
+        realm->zone[wx][wy].controlled_items.clear();
       }
     }
 
@@ -296,6 +299,7 @@ void GameState::cleanup_vars()
           chr->destroy();
         }
         realm->zone[wx][wy].characters.clear();
+        realm->zone[wx][wy].online_players.clear();
         for ( auto& chr : realm->zone[wx][wy].npcs )
         {
           chr->acct.clear();  // dave added 9/27/03, see above comment re: mutual references
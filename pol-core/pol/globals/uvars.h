@@ -174,6 +174,7 @@ public:
   std::unique_ptr<PeriodicTask> write_account_task;
   std::unique_ptr<PeriodicTask> update_sysload_task;
   std::unique_ptr<PeriodicTask> reload_pol_cfg_task;
+  std::unique_ptr<PeriodicTask> log_packet_timings_task;
 
   std::vector<Mobile::Attribute*> attributes;
   unsigned numAttributes;
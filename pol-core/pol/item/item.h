@@ -225,6 +225,8 @@ public:
   virtual Bscript::BObjectImp* make_ref() override;
   virtual Bscript::BObjectImp* get_script_member( const char* membername ) const override;
   virtual Bscript::BObjectImp* get_script_member_id( const int id ) const override;  /// id test
+  // members Item itself adds to UObject
+  Bscript::BObjectImp* get_item_script_member_id( const int id ) const;
   virtual Bscript::BObjectImp* set_script_member( const char* membername,
                                                   const std::string& value ) override;
   virtual Bscript::BObjectImp* set_script_member( const char* membername, int value ) override;
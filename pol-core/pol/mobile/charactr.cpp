@@ -443,7 +443,10 @@ bool Character::connected() const
 
 void Character::connected( bool newvalue )
 {
+  if ( connected() == newvalue )
+    return;
   mob_flags_.change( MOB_FLAGS::CONNECTED, newvalue );
+  Core::UpdateCharacterOnlineZone( this );
 }
 
 bool Character::has_active_client() const
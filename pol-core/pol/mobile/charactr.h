@@ -305,6 +305,8 @@ public:
 
   virtual Bscript::BObjectImp* get_script_member( const char* membername ) const override;
   virtual Bscript::BObjectImp* get_script_member_id( const int id ) const override;  // id test
+  // members Character itself adds to UObject
+  Bscript::BObjectImp* get_character_script_member_id( const int id ) const;
   virtual Bscript::BObjectImp* set_script_member( const char* membername,
                                                   const std::string& value ) override;
   virtual Bscript::BObjectImp* set_script_member( const char* membername, int value ) override;
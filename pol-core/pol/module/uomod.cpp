@@ -283,6 +283,7 @@ UOExecutorModule::~UOExecutorModule()
   if ( attached_item_ )
   {
     attached_item_->process( nullptr );
+    Core::UpdateItemControlZone( attached_item_ );
     attached_item_ = nullptr;
   }
   if ( registered_for_speech_events )
@@ -40,8 +40,10 @@
 #include "../../bscript/bobject.h"
 #include "../../bscript/bstruct.h"
 #include "../../bscript/eprog.h"
+#include "../../bscript/escriptv.h"
 #include "../../bscript/executor.h"
 #include "../../bscript/impstr.h"
+#include "../../bscript/scriptsampler.h"
 #include "../../clib/Program/ProgramConfig.h"
 #include "../../clib/clib.h"
 #include "../../clib/clib_endian.h"
@@ -74,6 +76,7 @@
 #include "../multi/multidef.h"
 #include "../network/cgdata.h"
 #include "../network/client.h"
+#include "../network/clienttransmit.h"
 #include "../network/packethelper.h"
 #include "../network/packetinterface.h"
 #include "../network/packets.h"
@@ -1784,6 +1787,21 @@ BObjectImp* GetScriptProfiles()
   return arr.release();
 }
 
+BObjectImp* GetLatencyHistogramObj( const IOStats::LatencyHistogram& histogram )
+{
+  std::unique_ptr<ObjArray> arr( new ObjArray );
+  for ( size_t i = 0; i < IOStats::LatencyHistogram::BUCKETS; ++i )
+  {
+    std::unique_ptr<BStruct> elem( new BStruct );
+    // the last bucket is open ended
+    if ( i + 1 < IOStats::LatencyHistogram::BUCKETS )
+      elem->addMember( "below_us", new BLong( 1 << i ) );
+    elem->addMember( "count", new BLong( histogram.counts[i] ) );
+    arr->addElement( elem.release() );
+  }
+  return arr.release();
+}
+
 BObjectImp* GetIoStatsObj( const IOStats& stats )
 {
   std::unique_ptr<BStruct> arr( new BStruct );
@@ -1810,6 +1828,28 @@ BObjectImp* GetIoStatsObj( const IOStats& stats )
     received->addElement( elem.release() );
   }
 
+  std::unique_ptr<BStruct> flush( new BStruct );
+  unsigned int syscalls = stats.flush.syscalls;
+  unsigned int packets = stats.flush.packets;
+  unsigned int bytes = stats.flush.bytes;
+  flush->addMember( "packets", new BLong( packets ) );
+  flush->addMember( "syscalls", new BLong( syscalls ) );
+  flush->addMember( "syscalls_saved", new BLong( packets > syscalls ? packets - syscalls : 0 ) );
+  flush->addMember( "bytes", new BLong( bytes ) );
+  flush->addMember( "bytes_per_flush", new Double( syscalls ? double( bytes ) / syscalls : 0.0 ) );
+  arr->addMember( "flush", flush.release() );
+
+  std::unique_ptr<BStruct> inbound( new BStruct );
+  unsigned int batches = stats.inbound.batches;
+  unsigned int messages = stats.inbound.messages;
+  inbound->addMember( "messages", new BLong( messages ) );
+  inbound->addMember( "batches", new BLong( batches ) );
+  inbound->addMember( "messages_per_batch",
+                      new Double( batches ? double( messages ) / batches : 0.0 ) );
+  inbound->addMember( "queue_latency", GetLatencyHistogramObj( stats.inbound.queue_latency ) );
+  inbound->addMember( "lock_wait", GetLatencyHistogramObj( stats.inbound.lock_wait ) );
+  arr->addMember( "inbound", inbound.release() );
+
   return arr.release();
 }
 
@@ -1823,6 +1863,48 @@ BObjectImp* GetQueuedIoStats()
   return GetIoStatsObj( Core::networkManager.queuedmode_iostats );
 }
 
+BObjectImp* GetPacketTimingsObj()
+{
+  std::unique_ptr<ObjArray> arr( new ObjArray );
+  const PacketTimings& timings = Core::networkManager.packet_timings;
+  for ( unsigned i = 0; i < 256; ++i )
+  {
+    if ( !timings.handler[i].count() && !timings.lock_wait[i].count() &&
+         !timings.build[i].count() )
+      continue;
+    std::unique_ptr<BStruct> elem( new BStruct );
+    elem->addMember( "pkt", new BLong( i ) );
+    elem->addMember( "handler", GetLatencyHistogramObj( timings.handler[i] ) );
+    elem->addMember( "handler_total_us",
+                     new Double( static_cast<double>( timings.handler[i].total_us ) ) );
+    elem->addMember( "lock_wait", GetLatencyHistogramObj( timings.lock_wait[i] ) );
+    elem->addMember( "lock_wait_total_us",
+                     new Double( static_cast<double>( timings.lock_wait[i].total_us ) ) );
+    elem->addMember( "build", GetLatencyHistogramObj( timings.build[i] ) );
+    elem->addMember( "build_total_us",
+                     new Double( static_cast<double>( timings.build[i].total_us ) ) );
+    arr->addElement( elem.release() );
+  }
+  return arr.release();
+}
+
+BObjectImp* GetTransmitWorkersObj()
+{
+  std::unique_ptr<ObjArray> arr( new ObjArray );
+  const ClientTransmit& transmit = *Core::networkManager.clientTransmit;
+  for ( size_t i = 0; i < transmit.WorkerCount(); ++i )
+  {
+    const ClientTransmit::Worker& worker = transmit.GetWorker( i );
+    std::unique_ptr<BStruct> elem( new BStruct );
+    elem->addMember( "depth", new BLong( worker.depth ) );
+    elem->addMember( "entries", new BLong( worker.entries ) );
+    elem->addMember( "batches", new BLong( worker.batches ) );
+    elem->addMember( "drain_latency", GetLatencyHistogramObj( worker.drain_latency ) );
+    arr->addElement( elem.release() );
+  }
+  return arr.release();
+}
+
 BObjectImp* GetPktStatusObj()
 {
   using namespace PacketWriterDefs;
@@ -1851,6 +1933,38 @@ BObjectImp* GetPktStatusObj()
   return pkts.release();
 }
 
+BObjectImp* GetPktPoolObj()
+{
+  std::unique_ptr<ObjArray> pkts( new ObjArray );
+  PacketsSingleton* singleton = networkManager.packetsSingleton.get();
+  for ( const auto& queue : *singleton->getPackets() )
+  {
+    const PacketPoolStats& stats = singleton->getStats( queue.first );
+    if ( !stats.requests )
+      continue;
+    std::unique_ptr<BStruct> elem( new BStruct );
+    elem->addMember( "pkt", new BLong( queue.first ) );
+    elem->addMember( "requests", new BLong( stats.requests ) );
+    elem->addMember( "local_hits", new BLong( stats.local_hits ) );
+    elem->addMember( "pool_hits", new BLong( stats.pool_hits ) );
+    elem->addMember( "misses", new BLong( stats.misses ) );
+    elem->addMember( "outstanding", new BLong( stats.outstanding ) );
+    elem->addMember( "peak_outstanding", new BLong( stats.peak_outstanding ) );
+    pkts->addElement( elem.release() );
+  }
+  return pkts.release();
+}
+
+BObjectImp* GetExecutorPoolObj()
+{
+  const auto& stats = scriptScheduler.executor_pool_stats();
+  std::unique_ptr<BStruct> pool( new BStruct );
+  pool->addMember( "created", new Double( static_cast<double>( stats.created ) ) );
+  pool->addMember( "reused", new Double( static_cast<double>( stats.reused ) ) );
+  pool->addMember( "pooled", new BLong( static_cast<int>( scriptScheduler.pooled_executors() ) ) );
+  return pool.release();
+}
+
 BObjectImp* GetCoreVariable( const char* corevar )
 {
 #define LONG_COREVAR( name, expr )      \
@@ -1889,6 +2003,12 @@ BObjectImp* GetCoreVariable( const char* corevar )
   LONG_COREVAR( scripts_ontime_per_min, GET_PROFILEVAR_PER_MIN( scripts_ontime ) );
 
   LONG_COREVAR( instr_per_min, stateManager.profilevars.last_sipm );
+  if ( stricmp( corevar, "inline_cache_hits" ) == 0 )
+    return new Double( static_cast<double>( Bscript::escript_inline_cache_hits ) );
+  if ( stricmp( corevar, "inline_cache_misses" ) == 0 )
+    return new Double( static_cast<double>( Bscript::escript_inline_cache_misses ) );
+  if ( stricmp( corevar, "script_samples" ) == 0 )
+    return new Double( static_cast<double>( Bscript::script_sampler.samples() ) );
   LONG_COREVAR( priority_divide, scriptScheduler.priority_divide );
   if ( stricmp( corevar, "version" ) == 0 )
     return new String( POL_VERSION_STR );
@@ -1904,12 +2024,20 @@ BObjectImp* GetCoreVariable( const char* corevar )
     return GetAllScriptList();
   if ( stricmp( corevar, "script_profiles" ) == 0 )
     return GetScriptProfiles();
+  if ( stricmp( corevar, "executor_pool" ) == 0 )
+    return GetExecutorPoolObj();
   if ( stricmp( corevar, "iostats" ) == 0 )
     return GetIoStats();
   if ( stricmp( corevar, "queued_iostats" ) == 0 )
     return GetQueuedIoStats();
+  if ( stricmp( corevar, "packet_timings" ) == 0 )
+    return GetPacketTimingsObj();
+  if ( stricmp( corevar, "transmit_workers" ) == 0 )
+    return GetTransmitWorkersObj();
   if ( stricmp( corevar, "pkt_status" ) == 0 )
     return GetPktStatusObj();
+  if ( stricmp( corevar, "pkt_pool" ) == 0 )
+    return GetPktPoolObj();
   if ( stricmp( corevar, "memory_usage" ) == 0 )
     return new BLong( static_cast<int>( Clib::getCurrentMemoryUsage() / 1024 ) );
 
@@ -1956,6 +2084,32 @@ BObjectImp* PolCore::call_polmethod( const char* methodname, UOExecutor& ex )
     clear_script_profile_counters();
     return new BLong( 1 );
   }
+  else if ( stricmp( methodname, "start_script_sampling" ) == 0 )
+  {
+    if ( ex.numParams() > 1 )
+      return new BError(
+          "polcore.start_script_sampling([samples_per_second]) takes at most 1 parameter." );
+    int rate = 1000;
+    if ( ex.numParams() == 1 && !ex.getParam( 0, rate, 1, 100000 ) )
+      return nullptr;
+    start_script_sampling( static_cast<unsigned int>( rate ) );
+    return new BLong( 1 );
+  }
+  else if ( stricmp( methodname, "stop_script_sampling" ) == 0 )
+  {
+    if ( ex.numParams() > 0 )
+      return new BError( "polcore.stop_script_sampling() doesn't take parameters." );
+    if ( !Bscript::script_sampler.running() )
+      return new BError( "Script sampling is not running." );
+    return new String( stop_script_sampling() );
+  }
+  else if ( stricmp( methodname, "clear_packet_timings" ) == 0 )
+  {
+    if ( ex.numParams() > 0 )
+      return new BError( "polcore.clear_packet_timings() doesn't take parameters." );
+    Core::networkManager.packet_timings.reset();
+    return new BLong( 1 );
+  }
   else if ( stricmp( methodname, "internal" ) == 0 )  // Just for internal Development...
   {
     int type;
@@ -65,12 +65,14 @@ void send_objects_newly_inrange( Network::Client* client )
 {
   Mobile::Character* chr = client->chr;
 
-  WorldIterator<MobileFilter>::InVisualRange(
-      chr, [&]( Mobile::Character* zonechr ) { send_char_if_newly_inrange( zonechr, client ); } );
-  WorldIterator<ItemFilter>::InVisualRange(
-      chr, [&]( Items::Item* zoneitem ) { send_item_if_newly_inrange( zoneitem, client ); } );
-  WorldIterator<MultiFilter>::InRange(
-      chr->x, chr->y, chr->realm, RANGE_VISUAL_LARGE_BUILDINGS,
+  WorldIterator<MobileFilter>::NewlyInRange(
+      chr->x, chr->y, chr->lastx, chr->lasty, chr->realm, RANGE_VISUAL,
+      [&]( Mobile::Character* zonechr ) { send_char_if_newly_inrange( zonechr, client ); } );
+  WorldIterator<ItemFilter>::NewlyInRange(
+      chr->x, chr->y, chr->lastx, chr->lasty, chr->realm, RANGE_VISUAL,
+      [&]( Items::Item* zoneitem ) { send_item_if_newly_inrange( zoneitem, client ); } );
+  WorldIterator<MultiFilter>::NewlyInRange(
+      chr->x, chr->y, chr->lastx, chr->lasty, chr->realm, RANGE_VISUAL_LARGE_BUILDINGS,
       [&]( Multi::UMulti* zonemulti ) { send_multi_if_newly_inrange( zonemulti, client ); } );
 }
 
@@ -108,12 +110,14 @@ void send_objects_newly_inrange_on_boat( Network::Client* client, u32 serial )
   }
   else
   {
-    WorldIterator<MobileFilter>::InVisualRange(
-        chr, [&]( Mobile::Character* zonechr ) { send_char_if_newly_inrange( zonechr, client ); } );
-    WorldIterator<ItemFilter>::InVisualRange(
-        chr, [&]( Items::Item* zoneitem ) { send_item_if_newly_inrange( zoneitem, client ); } );
-    WorldIterator<MultiFilter>::InRange(
-        chr->x, chr->y, chr->realm, RANGE_VISUAL_LARGE_BUILDINGS,
+    WorldIterator<MobileFilter>::NewlyInRange(
+        chr->x, chr->y, chr->lastx, chr->lasty, chr->realm, RANGE_VISUAL,
+        [&]( Mobile::Character* zonechr ) { send_char_if_newly_inrange( zonechr, client ); } );
+    WorldIterator<ItemFilter>::NewlyInRange(
+        chr->x, chr->y, chr->lastx, chr->lasty, chr->realm, RANGE_VISUAL,
+        [&]( Items::Item* zoneitem ) { send_item_if_newly_inrange( zoneitem, client ); } );
+    WorldIterator<MultiFilter>::NewlyInRange(
+        chr->x, chr->y, chr->lastx, chr->lasty, chr->realm, RANGE_VISUAL_LARGE_BUILDINGS,
         [&]( Multi::UMulti* zonemulti ) { send_multi_if_newly_inrange( zonemulti, client ); } );
   }
 }
@@ -52,6 +52,7 @@ protected:
   virtual void destroy() override;
   virtual Bscript::BObjectImp* get_script_member( const char* membername ) const override;
   virtual Bscript::BObjectImp* get_script_member_id( const int id ) const override;  /// id test
+  virtual bool script_members_cacheable() const override { return false; }  // .multi
 
 private:
   ref_ptr<UBoat> boat_;
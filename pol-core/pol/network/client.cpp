@@ -43,15 +43,14 @@
 #include "../uworld.h"
 #include "cgdata.h"
 #include "cliface.h"
+#include "clientio.h"
 #include "pktdef.h"
 #include "pktin.h"
+#include "pktout.h"
 #include "xbuffer.h"
 
-
-#define PRE_ENCRYPT
-
-#ifndef PRE_ENCRYPT
-#include "sockio.h"
+#ifndef _WIN32
+#include <sys/uio.h>
 #endif
 
 #ifdef _MSC_VER
@@ -68,7 +67,6 @@ void cancel_trade( Mobile::Character* chr1 );
 namespace Network
 {
 unsigned int Client::instance_counter_;
-std::mutex ThreadedClient::_SocketMutex;
 
 ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient )
     : myClient( myClient ),
@@ -80,6 +78,7 @@ ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient
       encrypt_server_stream( false ),
       last_activity_at( 0 ),
       last_packet_at( 0 ),
+      _SocketMutex(),
       recv_state( RECV_STATE_CRYPTSEED_WAIT ),
       bufcheck1_AA( 0xAA ),
       buffer(),  // zero-initializes the buffer
@@ -89,10 +88,17 @@ ThreadedClient::ThreadedClient( Crypt::TCryptInfo& encryption, Client& myClient
       last_msgtype( 255 ),
       msgtype_filter( Core::networkManager.login_filter.get() ),
       checkpoint( -1 ),  // CNXBUG
-      first_xmit_buffer( nullptr ),
-      last_xmit_buffer( nullptr ),
-      n_queued( 0 ),
-      queued_bytes_counter( 0 )
+      xmit_flush_scheduled( false ),
+      readahead(),
+      readahead_pos( 0 ),
+      readahead_len( 0 ),
+      xmit_buffer(),
+      xmit_unflushed( false ),
+      xmit_backlogged( false ),
+      queued_bytes_counter( 0 ),
+      _inbound_pending( false ),
+      _InboundMutex(),
+      _InboundHandled()
 {
   memset( &counters, 0, sizeof counters );
   memset( &ipaddr, 0, sizeof( ipaddr ) );
@@ -134,10 +140,12 @@ Client::Client( ClientInterface& aInterface, Crypt::TCryptInfo& encryption )
 
 void Client::Delete( Client* client )
 {
-  std::lock_guard<std::mutex> lock( _SocketMutex );  // TODO: check if this is necessary
-  client->PreDelete();
-  delete client->cryptengine;  // TODO: move this into a unique_ptr<> or at least ~Client()
-  client->cryptengine = nullptr;
+  {
+    std::lock_guard<std::mutex> lock( client->_SocketMutex );  // TODO: check if this is necessary
+    client->PreDelete();
+    delete client->cryptengine;  // TODO: move this into a unique_ptr<> or at least ~Client()
+    client->cryptengine = nullptr;
+  }
   delete client;
 }
 
@@ -203,14 +211,9 @@ void Client::PreDelete()
   delete gd;
   gd = nullptr;
 
-  while ( first_xmit_buffer != nullptr )
-  {
-    Core::XmitBuffer* xbuffer = first_xmit_buffer;
-    first_xmit_buffer = first_xmit_buffer->next;
-    free( xbuffer );
-    --n_queued;
-  }
-  last_xmit_buffer = nullptr;
+  xmit_buffer.clear();
+  xmit_unflushed = false;
+  xmit_backlogged = false;
 
   // while (!movementqueue.empty())
   //  movementqueue.pop();
@@ -421,43 +424,8 @@ std::string Client::status() const
   return st;
 }
 
-void ThreadedClient::queue_data( const void* data, unsigned short datalen )
-{
-  THREAD_CHECKPOINT( active_client, 300 );
-  Core::XmitBuffer* xbuffer = (Core::XmitBuffer*)malloc( sizeof( Core::XmitBuffer ) - 1 + datalen );
-  THREAD_CHECKPOINT( active_client, 301 );
-  if ( xbuffer )
-  {
-    THREAD_CHECKPOINT( active_client, 302 );
-    xbuffer->next = nullptr;
-    xbuffer->nsent = 0;
-    xbuffer->lenleft = datalen;
-    memcpy( xbuffer->data, data, datalen );
-    THREAD_CHECKPOINT( active_client, 303 );
-    if ( first_xmit_buffer == nullptr || last_xmit_buffer == nullptr )
-    {  // in this case, last_xmit_buffer is also nullptr, so can't set its ->next.
-      THREAD_CHECKPOINT( active_client, 304 );
-      first_xmit_buffer = xbuffer;
-    }
-    else
-    {
-      THREAD_CHECKPOINT( active_client, 305 );
-      last_xmit_buffer->next = xbuffer;
-    }
-    THREAD_CHECKPOINT( active_client, 306 );
-    last_xmit_buffer = xbuffer;
-    ++n_queued;
-    queued_bytes_counter += datalen;
-  }
-  else
-  {
-    THREAD_CHECKPOINT( active_client, 307 );
-    POLLOG.Format( "Client#{}: Unable to allocate {} bytes for queued data.  Disconnecting.\n" )
-        << myClient.instance_ << ( sizeof( Core::XmitBuffer ) - 1 + datalen );
-    disconnect = true;
-  }
-  THREAD_CHECKPOINT( active_client, 309 );
-}
+// flush immediately instead of waiting for the end of the transmit batch
+static const size_t XMIT_FLUSH_THRESHOLD = 16 * 1024;
 
 void ThreadedClient::xmit( const void* data, unsigned short datalen )
 {
@@ -470,134 +438,122 @@ void ThreadedClient::xmit( const void* data, unsigned short datalen )
     this->cryptengine->Encrypt( (void*)data, (void*)data, datalen );
   }
   THREAD_CHECKPOINT( active_client, 200 );
-  if ( last_xmit_buffer )  // this client already backlogged, schedule for later
+  xmit_buffer.append( data, datalen );
+  xmit_unflushed = true;
+  Core::networkManager.iostats.flush.packets++;
+  if ( xmit_backlogged )  // this client already backlogged, client thread sends when writable
   {
     THREAD_CHECKPOINT( active_client, 201 );
-    queue_data( data, datalen );
-    THREAD_CHECKPOINT( active_client, 202 );
+    queued_bytes_counter += datalen;
     return;
   }
   THREAD_CHECKPOINT( active_client, 203 );
+  if ( xmit_buffer.size() >= XMIT_FLUSH_THRESHOLD )
+    send_xmit_buffer();
+  THREAD_CHECKPOINT( active_client, 214 );
+}
 
-  /* client not backlogged - try to send. */
-  const unsigned char* cdata = (const unsigned char*)data;
-  int nsent;
+void ThreadedClient::send_xmit_buffer()
+{
+  if ( xmit_buffer.empty() || csocket == INVALID_SOCKET )
+    return;
+  const unsigned char* seg[2];
+  size_t seglen[2];
+  int nseg = xmit_buffer.segments( seg, seglen );
+  size_t datalen = xmit_buffer.size();
 
-  if ( -1 == ( nsent = send( csocket, (const char*)cdata, datalen, 0 ) ) )
+  THREAD_CHECKPOINT( active_client, 204 );
+#ifdef _WIN32
+  WSABUF bufs[2];
+  for ( int i = 0; i < nseg; ++i )
   {
-    THREAD_CHECKPOINT( active_client, 204 );
-    int sckerr = socket_errno;
+    bufs[i].buf = (char*)seg[i];
+    bufs[i].len = static_cast<ULONG>( seglen[i] );
+  }
+  DWORD nbytes = 0;
+  int nsent = -1;
+  if ( WSASend( csocket, bufs, nseg, &nbytes, 0, nullptr, nullptr ) == 0 )
+    nsent = static_cast<int>( nbytes );
+#else
+  iovec iov[2];
+  for ( int i = 0; i < nseg; ++i )
+  {
+    iov[i].iov_base = const_cast<unsigned char*>( seg[i] );
+    iov[i].iov_len = seglen[i];
+  }
+  int nsent = static_cast<int>( writev( csocket, iov, nseg ) );
+#endif
+  Core::networkManager.iostats.flush.syscalls++;
 
+  if ( nsent == -1 )
+  {
+    THREAD_CHECKPOINT( active_client, 205 );
+    int sckerr = socket_errno;
     if ( sckerr == SOCKET_ERRNO( EWOULDBLOCK ) )
     {
-      THREAD_CHECKPOINT( active_client, 205 );
-      POLLOG_ERROR.Format( "Client#{}: Switching to queued data mode (1, {} bytes)\n" )
-          << myClient.instance_ << datalen;
-      THREAD_CHECKPOINT( active_client, 206 );
-      queue_data( data, datalen );
-      THREAD_CHECKPOINT( active_client, 207 );
-      return;
+      if ( !xmit_backlogged )
+      {
+        POLLOG_ERROR.Format( "Client#{}: Switching to queued data mode (1, {} bytes)\n" )
+            << myClient.instance_ << datalen;
+        xmit_backlogged = true;
+      }
     }
     else
     {
-      THREAD_CHECKPOINT( active_client, 208 );
       if ( !disconnect )
-        POLLOG_ERROR.Format( "Client#{}: Disconnecting client due to send() error (1): {}\n" )
+        POLLOG_ERROR.Format( "Client#{}: Disconnecting client due to send() error: {}\n" )
             << myClient.instance_ << sckerr;
       disconnect = true;
-      THREAD_CHECKPOINT( active_client, 209 );
-      return;
     }
+    return;
   }
-  else  // no error
+
+  THREAD_CHECKPOINT( active_client, 210 );
+  xmit_buffer.consume( nsent );
+  xmit_unflushed = !xmit_buffer.empty();
+  counters.bytes_transmitted += nsent;
+  Core::networkManager.polstats.bytes_sent += nsent;
+  Core::networkManager.iostats.flush.bytes += nsent;
+  if ( !xmit_buffer.empty() )  // anything left? if so, wait till the socket is writable again
   {
-    THREAD_CHECKPOINT( active_client, 210 );
-    datalen -= static_cast<unsigned short>( nsent );
-    counters.bytes_transmitted += nsent;
-    Core::networkManager.polstats.bytes_sent += nsent;
-    if ( datalen )  // anything left? if so, queue for later.
+    if ( !xmit_backlogged )
     {
-      THREAD_CHECKPOINT( active_client, 211 );
-      POLLOG_ERROR.Format( "Client#{}: Switching to queued data mode (2)\n" ) << myClient.instance_;
-      THREAD_CHECKPOINT( active_client, 212 );
-      queue_data( cdata + nsent, datalen );
-      THREAD_CHECKPOINT( active_client, 213 );
+      POLLOG_ERROR.Format( "Client#{}: Switching to queued data mode (2)\n" )
+          << myClient.instance_;
+      xmit_backlogged = true;
     }
   }
-  THREAD_CHECKPOINT( active_client, 214 );
+  else if ( xmit_backlogged )
+  {
+    POLLOG.Format( "Client#{}: Leaving queued mode ({} bytes xmitted)\n" )
+        << myClient.instance_ << queued_bytes_counter;
+    xmit_backlogged = false;
+    queued_bytes_counter = 0;
+  }
 }
 
 void ThreadedClient::send_queued_data()
 {
   std::lock_guard<std::mutex> lock( _SocketMutex );
-  Core::XmitBuffer* xbuffer;
-  // hand off data to the sockets layer until it won't take any more.
-  // note if a buffer is sent in full, we try to send the next one, ad infinitum
-  while ( nullptr != ( xbuffer = first_xmit_buffer ) )
-  {
-    int nsent;
-    nsent = send( csocket, (char*)&xbuffer->data[xbuffer->nsent], xbuffer->lenleft, 0 );
-    if ( nsent == -1 )
-    {
-#ifdef _WIN32
-      int sckerr = WSAGetLastError();
-#else
-      int sckerr = errno;
-#endif
-      if ( sckerr == SOCKET_ERRNO( EWOULDBLOCK ) )
-      {
-        // do nothing.  it'll be re-queued later, when it won't block.
-        return;
-      }
-      else
-      {
-        if ( !disconnect )
-          POLLOG.Format( "Client#{}: Disconnecting client due to send() error (2): {}\n" )
-              << myClient.instance_ << sckerr;
-        disconnect = true;
-        return;
-      }
-    }
-    else
-    {
-      xbuffer->nsent += static_cast<unsigned short>( nsent );
-      xbuffer->lenleft -= static_cast<unsigned short>( nsent );
-      counters.bytes_transmitted += nsent;
-      Core::networkManager.polstats.bytes_sent += nsent;
-      if ( xbuffer->lenleft == 0 )
-      {
-        first_xmit_buffer = first_xmit_buffer->next;
-        if ( first_xmit_buffer == nullptr )
-        {
-          last_xmit_buffer = nullptr;
-          POLLOG.Format( "Client#{}: Leaving queued mode ({} bytes xmitted)\n" )
-              << myClient.instance_ << queued_bytes_counter;
-          queued_bytes_counter = 0;
-        }
-        free( xbuffer );
-        --n_queued;
-      }
-    }
-  }
+  send_xmit_buffer();
 }
 
-// 33 01 "encrypted": 4F FA
-static const unsigned char pause_pre_encrypted[2] = {0x4F, 0xFA};
-// 33 00 "encrypted": 4C D0
-static const unsigned char restart_pre_encrypted[2] = {0x4C, 0xD0};
+void ThreadedClient::flush_xmit_buffer()
+{
+  std::lock_guard<std::mutex> lock( _SocketMutex );
+  if ( !xmit_backlogged )
+    send_xmit_buffer();
+}
 
 void Client::send_pause()
 {
   if ( Core::networkManager.uoclient_protocol.EnableFlowControlPackets && !paused_ )
   {
-#ifndef PRE_ENCRYPT
-    PKTOUT_33 msg;
-    msg.msgtype = PKTOUT_33_ID;
+    // queued like every other packet, the transmit thread owns the xmit buffer
+    Core::PKTOUT_33 msg;
+    msg.msgtype = Core::PKTOUT_33_ID;
     msg.flow = MSGOPT_33_FLOW_PAUSE;
-    transmit( this, &msg, sizeof msg );
-#else
-    xmit( pause_pre_encrypted, sizeof pause_pre_encrypted );
-#endif
+    Network::transmit( this, &msg, sizeof msg );
     paused_ = true;
   }
 }
@@ -611,18 +567,31 @@ void Client::pause()
   }
 }
 
+// pause() of the transmit thread: the 0x33 has to go out right before the packet it is sending,
+// so it is appended to the xmit buffer directly
+void Client::pause_locked()
+{
+  if ( pause_count )
+    return;
+  if ( Core::networkManager.uoclient_protocol.EnableFlowControlPackets && !paused_ )
+  {
+    Core::PKTOUT_33 msg;
+    msg.msgtype = Core::PKTOUT_33_ID;
+    msg.flow = MSGOPT_33_FLOW_PAUSE;
+    transmit_encrypted( &msg, sizeof msg );
+    paused_ = true;
+  }
+  pause_count = 1;
+}
+
 void Client::send_restart()
 {
   if ( paused_ )
   {
-#ifndef PRE_ENCRYPT
-    PKTOUT_33 msg;
-    msg.msgtype = PKTOUT_33_ID;
+    Core::PKTOUT_33 msg;
+    msg.msgtype = Core::PKTOUT_33_ID;
     msg.flow = MSGOPT_33_FLOW_RESTART;
-    transmit( this, &msg, sizeof msg );
-#else
-    xmit( restart_pre_encrypted, sizeof restart_pre_encrypted );
-#endif
+    Network::transmit( this, &msg, sizeof msg );
     paused_ = false;
   }
 }
@@ -635,7 +604,7 @@ void Client::restart()
 
 // Note: this doesnt test single packets it only summs the delay and tests
 // here only the "start"-value is set the additional delay is set in PKT_02 handler
-bool Client::SpeedHackPrevention( bool add )
+bool Client::SpeedHackPrevention( const unsigned char* pktbuffer, bool add )
 {
   if ( ( !movementqueue.empty() ) && ( add ) )
   {
@@ -647,7 +616,7 @@ bool Client::SpeedHackPrevention( bool add )
       return false;
     }
     PacketThrottler throttlestruct;
-    memcpy( &throttlestruct.pktbuffer, &buffer, PKTIN_02_SIZE );
+    memcpy( &throttlestruct.pktbuffer, pktbuffer, PKTIN_02_SIZE );
     movementqueue.push( throttlestruct );
     return false;
   }
@@ -673,7 +642,7 @@ bool Client::SpeedHackPrevention( bool add )
         return false;
       }
       PacketThrottler throttlestruct;
-      memcpy( &throttlestruct.pktbuffer, &buffer, sizeof( throttlestruct.pktbuffer ) );
+      memcpy( &throttlestruct.pktbuffer, pktbuffer, sizeof( throttlestruct.pktbuffer ) );
       movementqueue.push( throttlestruct );
     }
     return false;
@@ -695,12 +664,7 @@ size_t Client::estimatedSize() const
 {
   Clib::SpinLockGuard guard( _fpLog_lock );
   size_t size = sizeof( Client ) + fpLog.capacity() + version_.capacity();
-  Core::XmitBuffer* buffer_size = first_xmit_buffer;
-  while ( buffer_size != nullptr )
-  {
-    size += sizeof( buffer_size ) + buffer_size->lenleft;
-    buffer_size = buffer_size->next;
-  }
+  size += xmit_buffer.capacity();
   size += 3 * sizeof( PacketThrottler* ) + movementqueue.size() * sizeof( PacketThrottler );
   if ( gd != nullptr )
     size += gd->estimatedSize();
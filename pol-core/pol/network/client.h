@@ -23,6 +23,7 @@
 #define __CLIENT_H
 
 #include <atomic>
+#include <condition_variable>
 #include <cstring>
 #include <memory>
 #include <mutex>
@@ -39,6 +40,7 @@
 #include "../polclock.h"
 #include "pktdef.h"
 #include "pktin.h"
+#include "xbuffer.h"
 
 namespace Pol
 {
@@ -50,7 +52,6 @@ class BStruct;
 namespace Core
 {
 class MessageTypeFilter;
-struct XmitBuffer;
 }  // namespace Core
 namespace Accounts
 {
@@ -68,6 +69,7 @@ namespace Network
 {
 class ClientGameData;
 class ClientInterface;
+class PreparedPacket;
 
 const u16 T2A = 0x01;
 const u16 LBR = 0x02;
@@ -145,9 +147,20 @@ public:
   // methods below should be protected?
   bool have_queued_data() const;
   void send_queued_data();
+  bool have_unflushed_data() const;
+  void flush_xmit_buffer();
 
   void recv_remaining( int total_expected );
   void recv_remaining_nocrypt( int total_expected );
+  bool has_buffered_input() const;
+
+  // pol.cfg QueueInboundMessages: the handler of a queued message can change how the following
+  // ones get framed (crypt init, client type), so nothing more is framed until it ran
+  void inbound_queued();
+  void inbound_handled();
+  bool inbound_pending() const;
+  // false if the client disconnected or the server shuts down meanwhile
+  bool wait_inbound_handled();
 
   bool has_delayed_packets() const;
   void process_delayed_packets();
@@ -172,7 +185,7 @@ public:
   std::atomic<Core::polclock_t> last_activity_at;
   std::atomic<Core::polclock_t> last_packet_at;
 
-  static std::mutex _SocketMutex;
+  std::mutex _SocketMutex;
 
   enum e_recv_states
   {
@@ -197,17 +210,36 @@ public:
 
   sockaddr ipaddr;
 
+  // set by the transmit thread while this client waits for the flush at the end of the batch
+  bool xmit_flush_scheduled;
+
 protected:
-  Core::XmitBuffer* first_xmit_buffer;
-  Core::XmitBuffer* last_xmit_buffer;
-  int n_queued;
+  // incoming data is read with one recv as far as it fits, recv_remaining takes from there and
+  // decrypts only what it hands out (the crypt engine can get reinitialized between messages)
+  static const int READAHEAD_SIZE = 4096;
+  unsigned char readahead[READAHEAD_SIZE];
+  int readahead_pos;
+  int readahead_len;
+
+  // outgoing data is collected and flushed at the end of a transmit batch or when it exceeds
+  // a size threshold
+  Core::XmitBuffer xmit_buffer;
+  // !xmit_buffer.empty(), readable without _SocketMutex
+  std::atomic<bool> xmit_unflushed;
+  bool xmit_backlogged;      // socket would block, client thread sends when writable
   int queued_bytes_counter;  // only used for monitoring
 
+  std::atomic<bool> _inbound_pending;
+  std::mutex _InboundMutex;
+  std::condition_variable _InboundHandled;
+
   // we may want to track how many bytes total are outstanding,
   // and boot clients that are too far behind.
-  void queue_data( const void* data, unsigned short datalen );
   void transmit_encrypted( const void* data, int len );
   void xmit( const void* data, unsigned short datalen );
+  // needs _SocketMutex
+  void send_xmit_buffer();
+  int recv_readahead( unsigned char* out, int len );
 
 private:
   struct
@@ -238,6 +270,7 @@ public:
   void unregister();  // removes updater for vitals and takes client away from clientlist
 
   void transmit( const void* data, int len );  // always obtains PolLock when calling a SendFunction
+  void transmit( const PreparedPacket& packet );  // uses the shared compressed data if possible
 
   int on_close();     // Called after the connection is closed (returns how long until on_logoff)
   int test_logoff();  // Calls logofftest.ecl to determine how many seconds for the logoff timer
@@ -288,9 +321,11 @@ public:
 
   void pause();
   void restart();
+  // needs _SocketMutex
+  void pause_locked();
   std::atomic<int> pause_count;
 
-  bool SpeedHackPrevention( bool add = true );
+  bool SpeedHackPrevention( const unsigned char* pktbuffer, bool add = true );
   Bscript::BObjectImp* make_ref();
   weak_ptr<Client> getWeakPtr() const;
 
@@ -308,6 +343,8 @@ public:
   u8 movementsequence;
 
 private:
+  void transmit_packet( const void* data, int len, const PreparedPacket* prepared );
+
   std::string version_;
   Core::PKTIN_D9 clientinfo_;
   bool paused_;
@@ -317,7 +354,22 @@ private:
 
 inline bool ThreadedClient::have_queued_data() const
 {
-  return ( first_xmit_buffer != nullptr );
+  return xmit_backlogged;
+}
+
+inline bool ThreadedClient::has_buffered_input() const
+{
+  return readahead_pos < readahead_len;
+}
+
+inline bool ThreadedClient::inbound_pending() const
+{
+  return _inbound_pending;
+}
+
+inline bool ThreadedClient::have_unflushed_data() const
+{
+  return xmit_unflushed;
 }
 
 
@@ -5,11 +5,15 @@
  */
 
 
+#include <algorithm>
+#include <chrono>
 #include <errno.h>
 #include <mutex>
 #include <stddef.h>
+#include <string.h>
 #include <string>
 
+#include "../../clib/esignal.h"
 #include "../../clib/fdump.h"
 #include "../../clib/logfacility.h"
 #include "../../clib/network/sockets.h"
@@ -39,23 +43,43 @@ std::string ThreadedClient::ipaddrAsString() const
   return AddressToString( &this->ipaddr );
 }
 
-void ThreadedClient::recv_remaining( int total_expected )
+// Hands out up to len bytes of the read-ahead buffer, which gets refilled with a single recv once it
+// is empty. Returns like recv.
+int ThreadedClient::recv_readahead( unsigned char* out, int len )
 {
-  int count;
-  int max_expected = total_expected - bytes_received;
-
+  if ( readahead_pos == readahead_len )
   {
-    std::lock_guard<std::mutex> lock( _SocketMutex );
-    count = cryptengine->Receive( &buffer[bytes_received], max_expected, csocket );
+    int count;
+    {
+      std::lock_guard<std::mutex> lock( _SocketMutex );
+      count = recv( csocket, (char*)readahead, sizeof readahead, 0 );
+    }
+    if ( count <= 0 )
+      return count;
+
+    readahead_pos = 0;
+    readahead_len = count;
+    counters.bytes_received += count;
+    Core::networkManager.polstats.bytes_received += count;
   }
 
+  int count = std::min( len, readahead_len - readahead_pos );
+  memcpy( out, &readahead[readahead_pos], count );
+  readahead_pos += count;
+  return count;
+}
+
+void ThreadedClient::recv_remaining( int total_expected )
+{
+  int max_expected = total_expected - bytes_received;
+  int count = recv_readahead( &buffer[bytes_received], max_expected );
+
   if ( count > 0 )
   {
     passert( count <= max_expected );
 
+    cryptengine->Decrypt( &buffer[bytes_received], &buffer[bytes_received], count );
     bytes_received += count;
-    counters.bytes_received += count;
-    Core::networkManager.polstats.bytes_received += count;
   }
   else if ( count == 0 )  // graceful close
   {
@@ -69,19 +93,39 @@ void ThreadedClient::recv_remaining( int total_expected )
   }
 }
 
-void ThreadedClient::recv_remaining_nocrypt( int total_expected )
+void ThreadedClient::inbound_queued()
 {
-  int count;
+  std::lock_guard<std::mutex> lock( _InboundMutex );
+  _inbound_pending = true;
+}
 
+void ThreadedClient::inbound_handled()
+{
   {
-    std::lock_guard<std::mutex> lock( _SocketMutex );
-    count = recv( csocket, (char*)&buffer[bytes_received], total_expected - bytes_received, 0 );
+    std::lock_guard<std::mutex> lock( _InboundMutex );
+    _inbound_pending = false;
   }
+  _InboundHandled.notify_all();
+}
+
+bool ThreadedClient::wait_inbound_handled()
+{
+  std::unique_lock<std::mutex> lock( _InboundMutex );
+  while ( _inbound_pending )
+  {
+    if ( Clib::exit_signalled || !isReallyConnected() )
+      return false;
+    _InboundHandled.wait_for( lock, std::chrono::milliseconds( 100 ) );
+  }
+  return true;
+}
+
+void ThreadedClient::recv_remaining_nocrypt( int total_expected )
+{
+  int count = recv_readahead( &buffer[bytes_received], total_expected - bytes_received );
   if ( count > 0 )
   {
     bytes_received += count;
-    counters.bytes_received += count;
-    Core::networkManager.polstats.bytes_received += count;
   }
   else if ( count == 0 )  // graceful close
   {
@@ -95,97 +139,33 @@ void ThreadedClient::recv_remaining_nocrypt( int total_expected )
   }
 }
 
-/* NOTE: If this changes, code in client.cpp must change - pause() and restart() use
-   pre-encrypted values of 33 00 and 33 01.
-   */
 void ThreadedClient::transmit_encrypted( const void* data, int len )
 {
   THREAD_CHECKPOINT( active_client, 100 );
-  const unsigned char* cdata = (const unsigned char*)data;
-  unsigned char* pch;
-  int i;
-  int bidx;  // Offset in output byte
   EncryptedPktBuffer* outbuffer =
       PktHelper::RequestPacket<EncryptedPktBuffer>( ENCRYPTEDPKTBUFFER );
-  pch = reinterpret_cast<unsigned char*>( outbuffer->getBuffer() );
-  bidx = 0;
   THREAD_CHECKPOINT( active_client, 101 );
-  for ( i = 0; i < len; i++ )
-  {
-    THREAD_CHECKPOINT( active_client, 102 );
-    unsigned char ch = cdata[i];
-    int nbits = Core::keydesc[ch].nbits;
-    unsigned short inval = Core::keydesc[ch].bits_reversed;
-
-    THREAD_CHECKPOINT( active_client, 103 );
-
-    while ( nbits-- )
-    {
-      THREAD_CHECKPOINT( active_client, 104 );
-      *pch <<= 1;
-      if ( inval & 1 )
-        *pch |= 1;
-      bidx++;
-      if ( bidx == 8 )
-      {
-        THREAD_CHECKPOINT( active_client, 105 );
-        pch++;
-        bidx = 0;
-      }
-      THREAD_CHECKPOINT( active_client, 106 );
-
-      inval >>= 1;
-    }
-    THREAD_CHECKPOINT( active_client, 107 );
-  }
-  THREAD_CHECKPOINT( active_client, 108 );
-
-  {
-    int nbits = Core::keydesc[0x100].nbits;
-    unsigned short inval = Core::keydesc[0x100].bits_reversed;
-
-    THREAD_CHECKPOINT( active_client, 109 );
-
-    while ( nbits-- )
-    {
-      THREAD_CHECKPOINT( active_client, 110 );
-      *pch <<= 1;
-      if ( inval & 1 )
-        *pch |= 1;
-      bidx++;
-      THREAD_CHECKPOINT( active_client, 111 );
-      if ( bidx == 8 )
-      {
-        pch++;
-        bidx = 0;
-      }
-      THREAD_CHECKPOINT( active_client, 112 );
-
-      inval >>= 1;
-    }
-  }
-  THREAD_CHECKPOINT( active_client, 113 );
-
-  if ( bidx == 0 )
-  {
-    pch--;
-  }
-  else
-  {
-    *pch <<= ( 8 - bidx );
-  }
-  THREAD_CHECKPOINT( active_client, 114 );
-
-  passert_always( pch - reinterpret_cast<unsigned char*>( outbuffer->buffer ) + 1 <=
-                  int( sizeof outbuffer->buffer ) );
+  size_t outlen = Core::huffman_compress( static_cast<const unsigned char*>( data ), len,
+                                          reinterpret_cast<unsigned char*>( outbuffer->buffer ),
+                                          sizeof outbuffer->buffer );
+  passert_always( outlen != 0 );
   THREAD_CHECKPOINT( active_client, 115 );
-  xmit( &outbuffer->buffer, static_cast<unsigned short>(
-                                pch - reinterpret_cast<unsigned char*>( outbuffer->buffer ) + 1 ) );
+  xmit( &outbuffer->buffer, static_cast<unsigned short>( outlen ) );
   PktHelper::ReAddPacket( outbuffer );
   THREAD_CHECKPOINT( active_client, 116 );
 }
 
 void Client::transmit( const void* data, int len )
+{
+  transmit_packet( data, len, nullptr );
+}
+
+void Client::transmit( const PreparedPacket& packet )
+{
+  transmit_packet( packet.data(), packet.size(), &packet );
+}
+
+void Client::transmit_packet( const void* data, int len, const PreparedPacket* prepared )
 {
   ref_ptr<Core::BPacket> p;
   bool handled = false;
@@ -204,6 +184,7 @@ void Client::transmit( const void* data, int len )
       Core::PolLock lock;
       std::lock_guard<std::mutex> guard( _SocketMutex );
       CallOutgoingPacketExportedFunction( this, data, len, p, phd, handled );
+      prepared = nullptr;  // the hook may have altered the packet
     }
   }
 
@@ -234,7 +215,7 @@ void Client::transmit( const void* data, int len )
     return;
   }
 
-  if ( last_xmit_buffer )
+  if ( have_queued_data() )
   {
     Core::networkManager.queuedmode_iostats.sent[msgtype].count++;
     Core::networkManager.queuedmode_iostats.sent[msgtype].bytes += len;
@@ -244,8 +225,14 @@ void Client::transmit( const void* data, int len )
 
   if ( encrypt_server_stream )
   {
-    pause();
-    transmit_encrypted( data, len );
+    pause_locked();
+    if ( prepared != nullptr )
+    {
+      const auto& compressed = prepared->compressed();
+      xmit( compressed.data(), static_cast<unsigned short>( compressed.size() ) );
+    }
+    else
+      transmit_encrypted( data, len );
   }
   else
   {
@@ -0,0 +1,454 @@
+#include "clientreactor.h"
+
+#include <errno.h>
+#include <exception>
+#include <mutex>
+#include <string>
+
+#include "../../clib/esignal.h"
+#include "../../clib/logfacility.h"
+#include "../../clib/network/multipoller.h"
+#include "../../clib/network/sockets.h"
+#include "../../clib/threadhelp.h"
+#include "../../plib/systemstate.h"
+#include "../polclock.h"
+#include "../polsem.h"
+#include "client.h"
+#include "clientthread.h"
+#include <format/format.h>
+
+#define SESSION_CHECKPOINT( x ) client->checkpoint = x
+
+namespace Pol
+{
+namespace Network
+{
+namespace
+{
+const int WAIT_TIMEOUT_MS = 100;
+// while sessions wait for their queued handler (pol.cfg QueueInboundMessages)
+const int INBOUND_WAIT_TIMEOUT_MS = 1;
+// interval of the timeout, idle and writable checks of all sessions
+const Core::polclock_t CHECK_INTERVAL = Core::POLCLOCKS_PER_SEC / 10;
+// upper bound of messages handled for one client before the next client gets its turn
+const int MAX_MESSAGES_PER_EVENT = 8;
+}  // namespace
+
+class ClientReactor::Worker
+{
+public:
+  explicit Worker( unsigned id );
+  Worker( const Worker& ) = delete;
+  Worker& operator=( const Worker& ) = delete;
+
+  unsigned id() const { return _id; }
+  void add( Client* client );
+  void run();
+
+private:
+  struct Session
+  {
+    Client* client;  // nullptr once the client is handed over for deletion
+    bool notify_writable;
+    bool notify_readable;
+    bool closed;
+    bool buffered;  // listed in _buffered
+    bool waiting;   // listed in _waiting, reading is paused
+    Core::polclock_t logoff_at;  // when closed: time to run the logoff scripts
+    Core::polclock_t warned_at;  // last_activity_at of the last idle warning
+  };
+
+  void adopt_pending();
+  void resume_waiting();
+  void handle_events( Session* session, bool incoming, bool writable, bool error );
+  void check_sessions();
+  void check_session( Session* session, Core::polclock_t now );
+  void update_interest( Session* session );
+  void close( Session* session );
+  void finalize_all();
+
+  unsigned _id;
+  Clib::MultiPoller _poller;
+  std::vector<std::unique_ptr<Session>> _sessions;
+  // sessions which hit MAX_MESSAGES_PER_EVENT with more messages already read ahead
+  std::vector<Session*> _buffered;
+  // sessions with a message in the inbound queue, the next one gets framed after its handler ran
+  std::vector<Session*> _waiting;
+  std::mutex _pending_mutex;
+  std::vector<Client*> _pending;
+};
+
+ClientReactor::Worker::Worker( unsigned id )
+    : _id( id ),
+      _poller(),
+      _sessions(),
+      _buffered(),
+      _waiting(),
+      _pending_mutex(),
+      _pending()
+{
+}
+
+void ClientReactor::Worker::add( Client* client )
+{
+  std::lock_guard<std::mutex> lock( _pending_mutex );
+  _pending.push_back( client );
+}
+
+void ClientReactor::Worker::run()
+{
+  if ( !_poller.valid() )
+  {
+    POLLOG_ERROR.Format( "ClientReactor#{}: failed to create poller, errno={}\n" ) << _id << errno;
+    // still take care of the clients, they get disconnected right away
+  }
+  Core::polclock_t last_check = Core::polclock();
+  while ( !Clib::exit_signalled )
+  {
+    adopt_pending();
+
+    int timeout = WAIT_TIMEOUT_MS;
+    if ( !_buffered.empty() )
+      timeout = 0;
+    else if ( !_waiting.empty() )
+      timeout = INBOUND_WAIT_TIMEOUT_MS;
+    int res = _poller.wait_for_events( timeout );
+    if ( res < 0 )
+    {
+      int sckerr = socket_errno;
+      if ( sckerr != SOCKET_ERRNO( EINTR ) )
+      {
+        POLLOG_ERROR.Format( "ClientReactor#{}: poll res={}, sckerr={}\n" ) << _id << res << sckerr;
+        Core::pol_sleep_ms( WAIT_TIMEOUT_MS );
+      }
+    }
+    for ( int i = 0; i < _poller.count(); ++i )
+    {
+      Session* session = static_cast<Session*>( _poller.data( i ) );
+      if ( session->closed )
+        continue;
+      handle_events( session, _poller.incoming( i ), _poller.writable( i ), _poller.error( i ) );
+    }
+    // the socket doesn't report data which was already read ahead
+    std::vector<Session*> buffered;
+    buffered.swap( _buffered );
+    for ( Session* session : buffered )
+    {
+      session->buffered = false;
+      if ( !session->closed )
+        handle_events( session, true, false, false );
+    }
+    resume_waiting();
+
+    Core::polclock_t now = Core::polclock();
+    if ( now - last_check >= CHECK_INTERVAL )
+    {
+      last_check = now;
+      check_sessions();
+    }
+  }
+  finalize_all();
+}
+
+void ClientReactor::Worker::adopt_pending()
+{
+  std::vector<Client*> pending;
+  {
+    std::lock_guard<std::mutex> lock( _pending_mutex );
+    if ( _pending.empty() )
+      return;
+    pending.swap( _pending );
+  }
+  for ( Client* client : pending )
+  {
+    client->thread_pid = threadhelp::thread_pid();
+    client->last_packet_at = Core::polclock();
+    client->last_activity_at = Core::polclock();
+    if ( Plib::systemstate.config.loglevel >= 11 )
+    {
+      POLLOG.Format( "Network::Client#{} i/o handled by reactor thread {}\n" )
+          << client->instance_ << _id;
+    }
+
+    _sessions.emplace_back( new Session{client, false, true, false, false, false, 0, 0} );
+    Session* session = _sessions.back().get();
+    if ( !client->isReallyConnected() || !_poller.add( client->csocket, session ) )
+    {
+      POLLOG_INFO.Format( "Client#{}: ERROR - couldn't poll socket={}\n" )
+          << client->instance_ << client->csocket;
+      if ( client->csocket != INVALID_SOCKET )
+        client->forceDisconnect();
+      close( session );
+    }
+  }
+}
+
+// continues the sessions whose queued handler ran meanwhile
+void ClientReactor::Worker::resume_waiting()
+{
+  for ( size_t i = 0; i < _waiting.size(); )
+  {
+    Session* session = _waiting[i];
+    if ( !session->closed && session->client->inbound_pending() )
+    {
+      ++i;
+      continue;
+    }
+    _waiting[i] = _waiting.back();
+    _waiting.pop_back();
+    session->waiting = false;
+    if ( !session->closed )
+      handle_events( session, session->client->has_buffered_input(), false, false );
+  }
+}
+
+// the reactor version of threadedclient_io_step
+void ClientReactor::Worker::handle_events( Session* session, bool incoming, bool writable,
+                                           bool error )
+{
+  Client* client = session->client;
+  try
+  {
+    if ( error )
+      client->forceDisconnect();
+    if ( !client->isReallyConnected() )
+    {
+      close( session );
+      return;
+    }
+
+    // region Speedhack
+    if ( client->has_delayed_packets() )
+    {
+      Core::PolLock lck;
+      client->process_delayed_packets();
+    }
+    // endregion Speedhack
+
+    // a flooding client can't starve the others, the rest is handled in the next round
+    for ( int n = 0; incoming && client->isReallyConnected(); ++n )
+    {
+      if ( client->inbound_pending() )
+      {
+        if ( !session->waiting )
+        {
+          session->waiting = true;
+          _waiting.push_back( session );
+        }
+        break;
+      }
+      if ( n == MAX_MESSAGES_PER_EVENT )
+      {
+        if ( !session->buffered )
+        {
+          session->buffered = true;
+          _buffered.push_back( session );
+        }
+        break;
+      }
+      SESSION_CHECKPOINT( 6 );
+      bool processed = Core::process_data( client );
+      incoming = client->has_buffered_input();
+      if ( !processed )
+        continue;
+      SESSION_CHECKPOINT( 17 );
+      Core::message_received( client );
+      SESSION_CHECKPOINT( 7 );
+    }
+
+    if ( writable && client->have_queued_data() && client->isReallyConnected() )
+    {
+      Core::PolLock lck;
+      SESSION_CHECKPOINT( 8 );
+      client->send_queued_data();
+    }
+    SESSION_CHECKPOINT( 21 );
+
+    if ( !client->isReallyConnected() )
+      close( session );
+    else
+      update_interest( session );
+  }
+  catch ( std::string& str )
+  {
+    POLLOG_ERROR.Format( "Client#{}: Exception in i/o thread: {}! (checkpoint={})\n" )
+        << client->instance_ << str << client->checkpoint;
+    close( session );
+  }
+  catch ( const char* msg )
+  {
+    POLLOG_ERROR.Format( "Client#{}: Exception in i/o thread: {}! (checkpoint={})\n" )
+        << client->instance_ << msg << client->checkpoint;
+    close( session );
+  }
+  catch ( std::exception& ex )
+  {
+    POLLOG_ERROR.Format( "Client#{}: Exception in i/o thread: {}! (checkpoint={})\n" )
+        << client->instance_ << ex.what() << client->checkpoint;
+    close( session );
+  }
+}
+
+// Periodic part of threadedclient_io_step: delayed packets, idle and packet timeouts.
+// Also finishes pending logoffs and releases sessions of deleted clients.
+void ClientReactor::Worker::check_sessions()
+{
+  Core::polclock_t now = Core::polclock();
+  for ( size_t i = 0; i < _sessions.size(); )
+  {
+    Session* session = _sessions[i].get();
+    if ( !session->closed )
+    {
+      Client* client = session->client;
+      try
+      {
+        check_session( session, now );
+      }
+      catch ( std::exception& ex )
+      {
+        POLLOG_ERROR.Format( "Client#{}: Exception in i/o thread: {}! (checkpoint={})\n" )
+            << client->instance_ << ex.what() << client->checkpoint;
+        close( session );
+      }
+    }
+    else if ( session->client != nullptr && now >= session->logoff_at )
+    {
+      Core::client_io_logoff( session->client, true );
+      session->client = nullptr;
+    }
+
+    if ( session->closed && session->client == nullptr && !session->buffered && !session->waiting )
+    {
+      _sessions[i] = std::move( _sessions.back() );
+      _sessions.pop_back();
+    }
+    else
+      ++i;
+  }
+}
+
+void ClientReactor::Worker::check_session( Session* session, Core::polclock_t now )
+{
+  Client* client = session->client;
+  if ( !client->isReallyConnected() )
+  {
+    close( session );
+    return;
+  }
+
+  // region Speedhack
+  if ( client->has_delayed_packets() )
+  {
+    Core::PolLock lck;
+    client->process_delayed_packets();
+  }
+  // endregion Speedhack
+
+  if ( client->should_check_idle() )
+  {
+    Core::polclock_t last_activity = client->last_activity_at;
+    Core::polclock_t idle_mins = ( now - last_activity ) / ( 60 * Core::POLCLOCKS_PER_SEC );
+    if ( idle_mins >= Plib::systemstate.config.inactivity_disconnect_timeout )
+    {
+      client->forceDisconnect();
+      close( session );
+      return;
+    }
+    if ( idle_mins >= Plib::systemstate.config.inactivity_warning_timeout &&
+         session->warned_at != last_activity )
+    {
+      SESSION_CHECKPOINT( 4 );
+      session->warned_at = last_activity;
+      Core::PolLock lck;
+      client->warn_idle();
+    }
+  }
+
+  if ( ( now - client->last_packet_at ) / Core::POLCLOCKS_PER_SEC >= 120 )  // 2 mins
+  {
+    client->forceDisconnect();
+    close( session );
+    return;
+  }
+
+  update_interest( session );
+}
+
+// the poller only reports writable while there is data waiting for it and readable while no
+// handler is waiting in the inbound queue
+void ClientReactor::Worker::update_interest( Session* session )
+{
+  bool notify_writable = session->client->have_queued_data();
+  bool notify_readable = !session->waiting;
+  if ( notify_writable == session->notify_writable &&
+       notify_readable == session->notify_readable )
+    return;
+  if ( _poller.modify( session->client->csocket, session, notify_writable, notify_readable ) )
+  {
+    session->notify_writable = notify_writable;
+    session->notify_readable = notify_readable;
+  }
+}
+
+void ClientReactor::Worker::close( Session* session )
+{
+  Client* client = session->client;
+  _poller.remove( client->csocket, session );
+  session->closed = true;
+  SESSION_CHECKPOINT( 20 );
+
+  int seconds_wait = Core::client_io_close( client );
+  if ( seconds_wait > 0 )
+  {
+    // logoff scripts run by check_sessions when the time is up
+    session->logoff_at = client->last_activity_at + seconds_wait * Core::POLCLOCKS_PER_SEC;
+    return;
+  }
+  Core::client_io_logoff( client, seconds_wait >= 0 );
+  session->client = nullptr;
+}
+
+void ClientReactor::Worker::finalize_all()
+{
+  adopt_pending();
+  for ( auto& session : _sessions )
+  {
+    if ( !session->closed )
+      close( session.get() );
+    if ( session->client != nullptr )
+    {
+      Core::client_io_logoff( session->client, true );
+      session->client = nullptr;
+    }
+  }
+  _sessions.clear();
+}
+
+ClientReactor::ClientReactor( unsigned threads ) : _workers(), _next( 0 )
+{
+  for ( unsigned i = 0; i < threads; ++i )
+    _workers.emplace_back( new Worker( i ) );
+}
+
+ClientReactor::~ClientReactor() {}
+
+void ClientReactor::worker_thread( void* arg )
+{
+  static_cast<Worker*>( arg )->run();
+}
+
+void ClientReactor::start()
+{
+  for ( auto& worker : _workers )
+  {
+    std::string threadname = "ClientReactor " + std::to_string( worker->id() );
+    threadhelp::start_thread( worker_thread, threadname.c_str(), worker.get() );
+  }
+}
+
+void ClientReactor::add( Client* client )
+{
+  _workers[_next++ % _workers.size()]->add( client );
+}
+}  // namespace Network
+}  // namespace Pol
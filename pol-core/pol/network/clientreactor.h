@@ -0,0 +1,39 @@
+#ifndef CLIENTREACTOR_H
+#define CLIENTREACTOR_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Pol
+{
+namespace Network
+{
+class Client;
+
+// Reactor mode of the client i/o (pol.cfg NetworkReactorThreads):
+// instead of one thread per client a small fixed pool of threads waits on all client sockets and
+// runs the same process_data/handle_msg pipeline as the dedicated client threads.
+// Clients are assigned round robin and stay on their thread for the rest of the session.
+class ClientReactor
+{
+public:
+  explicit ClientReactor( unsigned threads );
+  ~ClientReactor();
+  ClientReactor( const ClientReactor& ) = delete;
+  ClientReactor& operator=( const ClientReactor& ) = delete;
+
+  void start();
+  // hands the i/o of a connected client over to the reactor, the reactor deletes it at the end
+  void add( Client* client );
+
+private:
+  class Worker;
+  static void worker_thread( void* arg );
+
+  std::vector<std::unique_ptr<Worker>> _workers;
+  std::atomic<unsigned> _next;
+};
+}  // namespace Network
+}  // namespace Pol
+#endif
@@ -1,5 +1,6 @@
 #include "clientthread.h"
 
+#include <chrono>
 #include <errno.h>
 #include <exception>
 #include <stddef.h>
@@ -29,6 +30,7 @@
 #include "../uworld.h"
 #include "cgdata.h"  // This might not be needed if the client has a clear_gd() method
 #include "client.h"
+#include "inboundqueue.h"
 #include "msgfiltr.h"  // Client could also have a method client->is_msg_allowed(), for example. Then this is not needed here.
 #include "msghandl.h"
 #include "packethelper.h"
@@ -131,27 +133,21 @@ bool threadedclient_io_step( Network::Client* session, Clib::SinglePoller& clien
   }
   // endregion Speedhack
 
-  if ( clientpoller.incoming() )
+  // one recv can read several messages ahead, all of them are handled before waiting again
+  bool incoming = clientpoller.incoming();
+  while ( incoming && session->isReallyConnected() )
   {
+    if ( !session->wait_inbound_handled() )
+      break;
     SESSION_CHECKPOINT( 6 );
     if ( process_data( session ) )
     {
       SESSION_CHECKPOINT( 17 );
-      PolLock lck;
-
-      // reset packet timer
-      session->last_packet_at = polclock();
-      if ( !check_inactivity( session ) )
-      {
+      if ( message_received( session ) )
         nidle = 0;
-        session->last_activity_at = polclock();
-      }
-
       SESSION_CHECKPOINT( 7 );
-      send_pulse();
-      if ( TaskScheduler::is_dirty() )
-        wake_tasks_thread();
     }
+    incoming = session->has_buffered_input();
   }
 
   polclock_t polclock_now = polclock();
@@ -199,28 +195,45 @@ void threadedclient_sleep_until( polclock_t when_logoff )
   }
 }
 
-void threadedclient_io_finalize( Network::Client* client )
+int client_io_close( Network::Client* client )
 {
-  int seconds_wait = 0;
+  POLLOG.Format( "Client#{} ({}): disconnected (account {})\n" )
+      << client->instance_ << client->ipaddrAsString()
+      << ( ( client->acct != nullptr ) ? client->acct->name() : "unknown" );
+
+  try
   {
     CLIENT_CHECKPOINT( 9 );
     PolLock lck;
-    seconds_wait = client->on_close();
+    return client->on_close();
   }
-
-  CLIENT_CHECKPOINT( 10 );
-  if ( seconds_wait > 0 )
+  catch ( std::exception& ex )
   {
-    polclock_t when_logoff = client->last_activity_at + seconds_wait * POLCLOCKS_PER_SEC;
-    threadedclient_sleep_until( when_logoff );
+    POLLOG.Format( "Client#{}: Exception in i/o thread: {}! (checkpoint={}, what={})\n" )
+        << client->instance_ << client->checkpoint << ex.what();
   }
+  return -1;
+}
 
+void client_io_logoff( Network::Client* client, bool logoff )
+{
   CLIENT_CHECKPOINT( 15 );
-  if ( client->chr )
+  if ( logoff && client->chr )
   {
-    PolLock lck;
-    client->on_logoff();
+    try
+    {
+      PolLock lck;
+      client->on_logoff();
+    }
+    catch ( std::exception& ex )
+    {
+      POLLOG.Format( "Client#{}: Exception in i/o thread: {}! (checkpoint={}, what={})\n" )
+          << client->instance_ << client->checkpoint << ex.what();
+    }
   }
+
+  // queue delete of client ptr see method doc for reason
+  Core::networkManager.clientTransmit->QueueDelete( client );
 }
 
 bool client_io_thread( Network::Client* client, bool login )
@@ -255,22 +268,14 @@ bool client_io_thread( Network::Client* client, bool login )
   if ( login && client->isConnected() )
     return true;
 
-  POLLOG.Format( "Client#{} ({}): disconnected (account {})\n" )
-      << client->instance_ << client->ipaddrAsString()
-      << ( ( client->acct != nullptr ) ? client->acct->name() : "unknown" );
-
-  try
-  {
-    threadedclient_io_finalize( client );
-  }
-  catch ( std::exception& ex )
+  int seconds_wait = client_io_close( client );
+  CLIENT_CHECKPOINT( 10 );
+  if ( seconds_wait > 0 )
   {
-    POLLOG.Format( "Client#{}: Exception in i/o thread: {}! (checkpoint={}, what={})\n" )
-        << client->instance_ << client->checkpoint << ex.what();
+    polclock_t when_logoff = client->last_activity_at + seconds_wait * POLCLOCKS_PER_SEC;
+    threadedclient_sleep_until( when_logoff );
   }
-
-  // queue delete of client ptr see method doc for reason
-  Core::networkManager.clientTransmit->QueueDelete( client );
+  client_io_logoff( client, seconds_wait >= 0 );
   return false;
 }
 
@@ -384,33 +389,19 @@ bool process_data( Network::Client* client )
         INFO_PRINT.Format( "Message Received: Type 0x{:X}, Length {} bytes\n" )
             << (int)msgtype << client->message_length;
 
-      PolLock lck;  // multithread
-      // it can happen that a client gets disconnected while waiting for the lock.
-      if ( client->isConnected() )
+      if ( networkManager.inboundQueue )
       {
-        if ( client->msgtype_filter->msgtype_allowed[msgtype] )
-        {
-          // region Speedhack
-          if ( ( settingsManager.ssopt.speedhack_prevention ) && ( msgtype == PKTIN_02_ID ) )
-          {
-            if ( !client->SpeedHackPrevention() )
-            {
-              // client->SpeedHackPrevention() added packet to queue
-              client->recv_state = Network::Client::RECV_STATE_MSGTYPE_WAIT;
-              CLIENT_CHECKPOINT( 28 );
-              return true;
-            }
-          }
-          // endregion Speedhack
-
-          client->handle_msg( client->buffer, client->bytes_received );
-        }
-        else
-        {
-          POLLOG_ERROR.Format( "Client#{} ({}, Acct {}) sent non-allowed message type 0x{:X}.\n" )
-              << client->instance_ << client->ipaddrAsString()
-              << ( client->acct ? client->acct->name() : "unknown" ) << (int)msgtype;
-        }
+        networkManager.inboundQueue->push( client, client->buffer, client->bytes_received );
+      }
+      else
+      {
+        auto lock_start = std::chrono::steady_clock::now();
+        PolLock lck;  // multithread
+        networkManager.packet_timings.lock_wait[msgtype].add(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - lock_start )
+                .count() );
+        dispatch_msg( client, client->buffer, client->bytes_received );
       }
       client->recv_state = Network::Client::RECV_STATE_MSGTYPE_WAIT;
       CLIENT_CHECKPOINT( 28 );
@@ -538,6 +529,61 @@ bool process_data( Network::Client* client )
   return false;
 }
 
+// Runs the handler of a complete message, called with PolLock held.
+void dispatch_msg( Network::Client* client, unsigned char* msg, int msglen )
+{
+  // it can happen that a client gets disconnected while waiting for the lock.
+  if ( !client->isConnected() )
+    return;
+
+  unsigned char msgtype = msg[0];
+  if ( client->msgtype_filter->msgtype_allowed[msgtype] )
+  {
+    // region Speedhack
+    if ( ( settingsManager.ssopt.speedhack_prevention ) && ( msgtype == PKTIN_02_ID ) )
+    {
+      if ( !client->SpeedHackPrevention( msg ) )
+      {
+        // client->SpeedHackPrevention() added packet to queue
+        return;
+      }
+    }
+    // endregion Speedhack
+
+    auto start = std::chrono::steady_clock::now();
+    client->handle_msg( msg, msglen );
+    networkManager.packet_timings.handler[msgtype].add(
+        std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() -
+                                                               start )
+            .count() );
+  }
+  else
+  {
+    POLLOG_ERROR.Format( "Client#{} ({}, Acct {}) sent non-allowed message type 0x{:X}.\n" )
+        << client->instance_ << client->ipaddrAsString()
+        << ( client->acct ? client->acct->name() : "unknown" ) << (int)msgtype;
+  }
+}
+
+// Bookkeeping of the i/o loop after process_data completed a message, the message is still in
+// client->buffer. Returns false if the message doesn't count as activity.
+bool message_received( Network::Client* client )
+{
+  client->last_packet_at = polclock();
+  bool active = !check_inactivity( client );
+  if ( active )
+    client->last_activity_at = polclock();
+
+  // with the inbound queue the handler didn't run yet, the queue thread sends the pulse
+  if ( !networkManager.inboundQueue )
+  {
+    send_pulse();
+    if ( TaskScheduler::is_dirty() )
+      wake_tasks_thread();
+  }
+  return active;
+}
+
 bool check_inactivity( Network::Client* client )
 {
   switch ( client->buffer[0] )
@@ -621,7 +667,7 @@ void handle_humongous_packet( Network::Client* client, unsigned int reported_siz
 namespace Pol::Network
 {
 // on_close determines how long to wait until on_logoff is called. An alternative would be to call
-// test_logoff directly in the threadedclient_io_finalize.
+// test_logoff directly in client_io_close.
 int Client::on_close()
 {
   unregister();
@@ -725,7 +771,7 @@ void ThreadedClient::process_delayed_packets()
 {
   PacketThrottler pkt = myClient.movementqueue.front();
 
-  if ( myClient.SpeedHackPrevention( false ) )
+  if ( myClient.SpeedHackPrevention( pkt.pktbuffer, false ) )
   {
     if ( isReallyConnected() )
     {
@@ -10,7 +10,15 @@ class ThreadedClient;
 namespace Pol::Core
 {
 bool client_io_thread( Network::Client* client, bool login );
+// Disconnect handling split in two steps, so that it can be used without blocking a thread:
+// client_io_close returns the seconds to wait before client_io_logoff should be called, -1 if
+// closing failed and the logoff scripts are to be skipped.
+// The client gets deleted by client_io_logoff.
+int client_io_close( Network::Client* client );
+void client_io_logoff( Network::Client* client, bool logoff );
 bool process_data( Network::Client* client );
+void dispatch_msg( Network::Client* client, unsigned char* msg, int msglen );
+bool message_received( Network::Client* client );
 bool check_inactivity( Network::Client* client );
 
 void handle_unknown_packet( Network::Client* client );
@@ -1,7 +1,13 @@
 #include "clienttransmit.h"
 
+#include <cstring>
+#include <string>
+
 #include "../../clib/esignal.h"
+#include "../../clib/passert.h"
 #include "../../clib/rawtypes.h"
+#include "../../clib/threadhelp.h"
+#include "../ctable.h"
 #include "../globals/network.h"
 #include "../polsem.h"
 #include "client.h"
@@ -10,70 +16,176 @@ namespace Pol
 {
 namespace Network
 {
-ClientTransmit::ClientTransmit() : _transmitqueue() {}
+PreparedPacket::PreparedPacket( const void* data, int len )
+    : _data( static_cast<const u8*>( data ), static_cast<const u8*>( data ) + len ),
+      _compress_once(),
+      _compressed()
+{
+}
+
+bool PreparedPacket::equals( const void* data, int len ) const
+{
+  return size() == len && std::memcmp( _data.data(), data, len ) == 0;
+}
+
+const std::vector<u8>& PreparedPacket::compressed() const
+{
+  std::call_once( _compress_once, [this]() {
+    // each byte needs at most 11 bits, plus the terminator
+    _compressed.resize( ( _data.size() + 1 ) * 11 / 8 + 1 );
+    size_t len =
+        Core::huffman_compress( _data.data(), _data.size(), _compressed.data(), _compressed.size() );
+    passert_always( len != 0 );
+    _compressed.resize( len );
+  } );
+  return _compressed;
+}
+
+ClientTransmit::Worker::Worker( unsigned id_ )
+    : id( id_ ), queue(), depth( 0 ), entries( 0 ), batches( 0 ), drain_latency()
+{
+  for ( auto& count : drain_latency.counts )
+    count = 0;
+}
+
+ClientTransmit::ClientTransmit() : _workers()
+{
+  Init( 1 );
+}
 
 ClientTransmit::~ClientTransmit() {}
 
+void ClientTransmit::Init( unsigned workers )
+{
+  if ( workers == 0 )
+    workers = 1;
+  _workers.clear();
+  for ( unsigned i = 0; i < workers; ++i )
+    _workers.emplace_back( new Worker( i ) );
+}
+
+size_t ClientTransmit::WorkerCount() const
+{
+  return _workers.size();
+}
+
+const ClientTransmit::Worker& ClientTransmit::GetWorker( size_t index ) const
+{
+  return *_workers[index];
+}
+
+void ClientTransmit::StartThreads()
+{
+  for ( auto& worker : _workers )
+  {
+    std::string threadname = "ClientTransmit";
+    if ( _workers.size() > 1 )
+      threadname += " " + std::to_string( worker->id );
+    threadhelp::start_thread( ClientTransmitThread, threadname.c_str(), worker.get() );
+  }
+}
+
 void ClientTransmit::Cancel()
 {
-  _transmitqueue.cancel();
+  for ( auto& worker : _workers )
+    worker->queue.cancel();
+}
+
+void ClientTransmit::push( Client* client, TransmitData&& data )
+{
+  Worker& worker = *_workers[client->instance_ % _workers.size()];
+  data.client = client->getWeakPtr();
+  data.queued_at = std::chrono::steady_clock::now();
+  ++worker.depth;
+  worker.queue.push_move( std::move( data ) );
 }
+
 void ClientTransmit::AddToQueue( Client* client, const void* data, int len )
 {
   const u8* message = static_cast<const u8*>( data );
-  auto transmitdata = TransmitDataSPtr( new TransmitData );
-  transmitdata->client = client->getWeakPtr();
-  transmitdata->len = len;
-  transmitdata->data.assign( message, message + len );
-  transmitdata->disconnects = false;
-  _transmitqueue.push_move( std::move( transmitdata ) );
+  TransmitData transmitdata;
+  transmitdata.len = len;
+  transmitdata.data.assign( message, message + len );
+  push( client, std::move( transmitdata ) );
 }
 
-void ClientTransmit::QueueDisconnection( Client* client )
+void ClientTransmit::AddToQueue( Client* client, const PreparedPacketRef& packet )
 {
-  auto transmitdata = TransmitDataSPtr( new TransmitData );
-  transmitdata->disconnects = true;
-  transmitdata->client = client->getWeakPtr();
-  _transmitqueue.push_move( std::move( transmitdata ) );
+  TransmitData transmitdata;
+  transmitdata.len = packet->size();
+  transmitdata.prepared = packet;
+  push( client, std::move( transmitdata ) );
 }
 
-void ClientTransmit::QueueDelete( Client* client )
+void ClientTransmit::QueueDisconnection( Client* client )
 {
-  auto transmitdata = TransmitDataSPtr( new TransmitData );
-  transmitdata->remove = true;
-  transmitdata->client = client->getWeakPtr();
-  _transmitqueue.push_move( std::move( transmitdata ) );
+  TransmitData transmitdata;
+  transmitdata.disconnects = true;
+  push( client, std::move( transmitdata ) );
 }
 
-TransmitDataSPtr ClientTransmit::NextQueueEntry()
+void ClientTransmit::QueueDelete( Client* client )
 {
-  auto transmitdata = TransmitDataSPtr();
-  _transmitqueue.pop_wait( &transmitdata );
-  return transmitdata;
+  TransmitData transmitdata;
+  transmitdata.remove = true;
+  push( client, std::move( transmitdata ) );
 }
 
-void ClientTransmitThread()
+// Packets of one batch (everything queued since the last wakeup, usually one game step) are only
+// collected in the client xmit buffers and get flushed together at the end of the batch.
+void ClientTransmitThread( void* arg )
 {
-  ClientTransmit* transmit_instance = Core::networkManager.clientTransmit.get();
+  ClientTransmit::Worker* worker = static_cast<ClientTransmit::Worker*>( arg );
+  std::list<TransmitData> entries;
+  std::vector<weak_ptr<Client>> unflushed;
   while ( !Clib::exit_signalled )
   {
     try
     {
-      auto data = transmit_instance->NextQueueEntry();
-      if ( data->client.exists() )
+      worker->queue.pop_wait( &entries );
+      ++worker->batches;
+      for ( auto& data : entries )
       {
-        if ( data->remove )
+        --worker->depth;
+        ++worker->entries;
+        worker->drain_latency.add( std::chrono::duration_cast<std::chrono::microseconds>(
+                                       std::chrono::steady_clock::now() - data.queued_at )
+                                       .count() );
+        if ( !data.client.exists() )
+          continue;
+        if ( data.remove )
         {
+          data.client->flush_xmit_buffer();
           Core::PolLock lock;
-          Client::Delete( data->client.get_weakptr() );
+          Client::Delete( data.client.get_weakptr() );
+        }
+        else if ( data.disconnects )
+        {
+          data.client->flush_xmit_buffer();
+          data.client->forceDisconnect();
         }
-        else if ( data->disconnects )
+        else if ( data.client->isReallyConnected() )
         {
-          data->client->forceDisconnect();
+          if ( data.prepared )
+            data.client->transmit( *data.prepared );
+          else
+            data.client->transmit( static_cast<void*>( &data.data[0] ), data.len );
+          if ( !data.client->xmit_flush_scheduled && data.client->have_unflushed_data() )
+          {
+            data.client->xmit_flush_scheduled = true;
+            unflushed.push_back( data.client );
+          }
         }
-        else if ( data->client->isReallyConnected() )
-          data->client->transmit( static_cast<void*>( &data->data[0] ), data->len );
       }
+      entries.clear();
+      for ( auto& client : unflushed )
+      {
+        if ( !client.exists() )
+          continue;
+        client->xmit_flush_scheduled = false;
+        client->flush_xmit_buffer();
+      }
+      unflushed.clear();
     }
     catch ( ClientTransmitQueue::Canceled& )
     {
@@ -1,6 +1,9 @@
 #ifndef CLIENTSEND_H
 #define CLIENTSEND_H
 
+#include <atomic>
+#include <chrono>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -8,6 +11,7 @@
 #include "../../clib/message_queue.h"
 #include "../../clib/rawtypes.h"
 #include "../../clib/weakptr.h"
+#include "iostats.h"
 
 namespace Pol
 {
@@ -15,43 +19,90 @@ namespace Network
 {
 class Client;
 
+// Immutable packet which can be queued for any number of clients.
+// The huffman compressed stream data is computed once on first use and shared by all of them.
+class PreparedPacket
+{
+public:
+  PreparedPacket( const void* data, int len );
+  PreparedPacket( const PreparedPacket& ) = delete;
+  PreparedPacket& operator=( const PreparedPacket& ) = delete;
+
+  const u8* data() const { return _data.data(); }
+  int size() const { return static_cast<int>( _data.size() ); }
+  bool equals( const void* data, int len ) const;
+  const std::vector<u8>& compressed() const;
+
+private:
+  std::vector<u8> _data;
+  mutable std::once_flag _compress_once;
+  mutable std::vector<u8> _compressed;
+};
+typedef std::shared_ptr<const PreparedPacket> PreparedPacketRef;
+
 struct TransmitData
 {
   // store a weak_ptr as a guard for pkts after deleting
   weak_ptr<Client> client;
   int len;
   std::vector<u8> data;
+  PreparedPacketRef prepared;  // used instead of data if set
   bool disconnects;
   bool remove;
+  std::chrono::steady_clock::time_point queued_at;
 
-  TransmitData() : client( 0 ), len( 0 ), disconnects( false ), remove( false ){};
+  TransmitData() : client( 0 ), len( 0 ), disconnects( false ), remove( false ), queued_at(){};
 };
 
-typedef std::unique_ptr<TransmitData> TransmitDataSPtr;
-typedef Clib::message_queue<TransmitDataSPtr> ClientTransmitQueue;
+typedef Clib::message_queue<TransmitData> ClientTransmitQueue;
 
+// The queued entries are spread over a number of workers (pol.cfg TransmitThreads), each with its
+// own queue and thread. A client always maps to the same worker, so everything queued for it
+// (packets, disconnection and deletion) is processed in order, while a slow client or a big
+// broadcast only occupies its own worker.
 class ClientTransmit
 {
 public:
+  struct Worker
+  {
+    Worker( unsigned id );
+    Worker( const Worker& ) = delete;
+    Worker& operator=( const Worker& ) = delete;
+
+    unsigned id;
+    ClientTransmitQueue queue;
+    std::atomic<unsigned int> depth;    // currently queued entries
+    std::atomic<unsigned int> entries;  // processed entries
+    std::atomic<unsigned int> batches;
+    IOStats::LatencyHistogram drain_latency;  // from queueing until the entry is processed
+  };
+
   ClientTransmit();
   ~ClientTransmit();
   ClientTransmit( const ClientTransmit& ) = delete;
   ClientTransmit& operator=( const ClientTransmit& ) = delete;
 
+  // sets the number of workers, has to be called before the first client connects
+  void Init( unsigned workers );
+  size_t WorkerCount() const;
+  const Worker& GetWorker( size_t index ) const;
+  void StartThreads();
+
   void AddToQueue( Client* client, const void* data, int len );
+  void AddToQueue( Client* client, const PreparedPacketRef& packet );
   void QueueDisconnection( Client* client );
   // queue delete and perform it in transmitthread, to be sure
   // that the weak_ptr stays valid without PolLock
   void QueueDelete( Client* client );
   void Cancel();
 
-  TransmitDataSPtr NextQueueEntry();
-
 private:
-  ClientTransmitQueue _transmitqueue;
+  void push( Client* client, TransmitData&& data );
+
+  std::vector<std::unique_ptr<Worker>> _workers;
 };
 
-void ClientTransmitThread();
+void ClientTransmitThread( void* worker );
 }  // namespace Network
 }  // namespace Pol
 #endif
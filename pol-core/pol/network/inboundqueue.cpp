@@ -0,0 +1,124 @@
+#include "inboundqueue.h"
+
+#include <exception>
+
+#include "../../clib/esignal.h"
+#include "../../clib/logfacility.h"
+#include "../globals/network.h"
+#include "../polsem.h"
+#include "../schedule.h"
+#include "client.h"
+#include "clientthread.h"
+#include <format/format.h>
+
+namespace Pol
+{
+namespace Network
+{
+namespace
+{
+unsigned long long usecs_since( std::chrono::steady_clock::time_point start,
+                                std::chrono::steady_clock::time_point now )
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>( now - start ).count();
+}
+}  // namespace
+
+InboundQueue::InboundQueue() : _queue() {}
+
+InboundQueue::~InboundQueue() {}
+
+void InboundQueue::Cancel()
+{
+  _queue.cancel();
+}
+
+void InboundQueue::push( Client* client, const unsigned char* data, int len )
+{
+  InboundMessage msg;
+  msg.client = client->getWeakPtr();
+  msg.data.assign( data, data + len );
+  msg.queued_at = std::chrono::steady_clock::now();
+  client->inbound_queued();
+  _queue.push_move( std::move( msg ) );
+}
+
+void InboundQueue::NextBatch( std::list<InboundMessage>* batch )
+{
+  if ( batch->empty() )
+    _queue.pop_wait( batch );
+  else
+    _queue.pop_remaining( batch );
+}
+
+void InboundQueue::Dispatch( std::list<InboundMessage>* batch )
+{
+  IOStats::Inbound& stats = Core::networkManager.iostats.inbound;
+  int handled = 0;
+
+  auto lock_start = std::chrono::steady_clock::now();
+  Core::PolLock lck;
+  auto now = std::chrono::steady_clock::now();
+  unsigned long long lock_wait = usecs_since( lock_start, now );
+  stats.lock_wait.add( lock_wait );
+
+  for ( auto itr = batch->begin(); itr != batch->end() && handled < MAX_MESSAGES_PER_BATCH; )
+  {
+    if ( !itr->client.exists() )
+    {
+      itr = batch->erase( itr );
+      continue;
+    }
+    Client* client = itr->client.get_weakptr();
+    ++handled;
+
+    now = std::chrono::steady_clock::now();
+    stats.queue_latency.add( usecs_since( itr->queued_at, now ) );
+    // every message of the batch waited for the one lock
+    Core::networkManager.packet_timings.lock_wait[itr->data[0]].add( lock_wait );
+    try
+    {
+      Core::dispatch_msg( client, itr->data.data(), static_cast<int>( itr->data.size() ) );
+    }
+    catch ( std::exception& )
+    {
+      // handle_msg already logged it, like in the i/o thread this ends the connection
+      client->forceDisconnect();
+    }
+    catch ( ... )
+    {
+      POLLOG_ERROR.Format( "Client#{}: Exception in message handler 0x{:X}\n" )
+          << client->instance_ << (int)itr->data[0];
+      client->forceDisconnect();
+    }
+    client->inbound_handled();
+    itr = batch->erase( itr );
+  }
+
+  stats.messages += handled;
+  ++stats.batches;
+
+  Core::send_pulse();
+  if ( Core::TaskScheduler::is_dirty() )
+    Core::wake_tasks_thread();
+}
+
+void InboundQueueThread()
+{
+  InboundQueue* queue = Core::networkManager.inboundQueue.get();
+  std::list<InboundMessage> batch;
+  while ( !Clib::exit_signalled )
+  {
+    try
+    {
+      queue->NextBatch( &batch );
+      queue->Dispatch( &batch );
+    }
+    catch ( InboundMessageQueue::Canceled& )
+    {
+      return;
+    }
+  }
+}
+}  // namespace Network
+}  // namespace Pol
@@ -0,0 +1,59 @@
+#ifndef INBOUNDQUEUE_H
+#define INBOUNDQUEUE_H
+
+#include <chrono>
+#include <list>
+#include <vector>
+
+#include "../../clib/message_queue.h"
+#include "../../clib/weakptr.h"
+
+namespace Pol
+{
+namespace Network
+{
+class Client;
+
+struct InboundMessage
+{
+  // store a weak_ptr as a guard for messages after deleting
+  weak_ptr<Client> client;
+  std::vector<unsigned char> data;
+  std::chrono::steady_clock::time_point queued_at;
+
+  InboundMessage() : client( 0 ), data(), queued_at(){};
+};
+
+typedef Clib::message_queue<InboundMessage> InboundMessageQueue;
+
+// Mode of pol.cfg QueueInboundMessages: the client i/o threads only frame the messages and push
+// them here, InboundQueueThread runs the handlers in batches with one PolLock per batch.
+// A client has at most one message in the queue, its i/o waits for the handler before framing the
+// next one (see ThreadedClient::inbound_queued), so a batch collects the messages of many clients.
+class InboundQueue
+{
+public:
+  // the lock is released after this many messages to let the other threads in
+  static const int MAX_MESSAGES_PER_BATCH = 512;
+
+  InboundQueue();
+  ~InboundQueue();
+  InboundQueue( const InboundQueue& ) = delete;
+  InboundQueue& operator=( const InboundQueue& ) = delete;
+
+  void push( Client* client, const unsigned char* data, int len );
+  void Cancel();
+
+  // waits for messages if there are none left in the batch, then appends all queued ones
+  void NextBatch( std::list<InboundMessage>* batch );
+  // handles a batch with PolLock, messages above the cap stay in the list
+  void Dispatch( std::list<InboundMessage>* batch );
+
+private:
+  InboundMessageQueue _queue;
+};
+
+void InboundQueueThread();
+}  // namespace Network
+}  // namespace Pol
+#endif
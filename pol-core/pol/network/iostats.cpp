@@ -8,6 +8,10 @@
 
 #include <cstring>
 
+#include "../../clib/logfacility.h"
+#include "../globals/network.h"
+#include <format/format.h>
+
 namespace Pol
 {
 namespace Network
@@ -16,6 +20,101 @@ IOStats::IOStats()
 {
   memset( &sent, 0, sizeof sent );
   memset( &received, 0, sizeof received );
+  flush.packets = 0;
+  flush.syscalls = 0;
+  flush.bytes = 0;
+  inbound.messages = 0;
+  inbound.batches = 0;
+  inbound.queue_latency.reset();
+  inbound.lock_wait.reset();
+}
+
+void IOStats::LatencyHistogram::add( unsigned long long usecs )
+{
+  size_t bucket = 0;
+  while ( bucket < BUCKETS - 1 && ( 1ull << bucket ) <= usecs )
+    ++bucket;
+  counts[bucket].fetch_add( 1, std::memory_order_relaxed );
+  total_us.fetch_add( usecs, std::memory_order_relaxed );
+}
+
+void IOStats::LatencyHistogram::reset()
+{
+  for ( auto& count : counts )
+    count = 0;
+  total_us = 0;
+}
+
+unsigned int IOStats::LatencyHistogram::count() const
+{
+  unsigned int sum = 0;
+  for ( const auto& count : counts )
+    sum += count.load( std::memory_order_relaxed );
+  return sum;
+}
+
+unsigned long long IOStats::LatencyHistogram::percentile( unsigned int pct ) const
+{
+  unsigned long long total = count();
+  if ( total == 0 )
+    return 0;
+  unsigned long long needed = ( total * pct + 99 ) / 100;
+  unsigned long long sum = 0;
+  for ( size_t i = 0; i < BUCKETS; ++i )
+  {
+    sum += counts[i].load( std::memory_order_relaxed );
+    if ( sum >= needed )
+      return 1ull << i;
+  }
+  return 1ull << ( BUCKETS - 1 );
+}
+
+PacketTimings::PacketTimings()
+{
+  reset();
+}
+
+void PacketTimings::reset()
+{
+  for ( size_t i = 0; i < 256; ++i )
+  {
+    handler[i].reset();
+    lock_wait[i].reset();
+    build[i].reset();
+  }
+}
+
+namespace
+{
+void write_timing( fmt::Writer& line, const char* name, const IOStats::LatencyHistogram& histogram )
+{
+  unsigned int count = histogram.count();
+  if ( count == 0 )
+    return;
+  line << " " << name << " " << count << "x total " << histogram.total_us << "us p50<"
+       << histogram.percentile( 50 ) << "us p99<" << histogram.percentile( 99 ) << "us";
+}
+}  // namespace
+
+void log_packet_timings()
+{
+  const PacketTimings& timings = Core::networkManager.packet_timings;
+  fmt::Writer tmp;
+  tmp << GET_LOG_FILESTAMP << "\n";
+  for ( unsigned int i = 0; i < 256; ++i )
+  {
+    if ( !timings.handler[i].count() && !timings.lock_wait[i].count() &&
+         !timings.build[i].count() )
+      continue;
+    tmp.Format( "  0x{:02X}:" ) << i;
+    write_timing( tmp, "handler", timings.handler[i] );
+    write_timing( tmp, "lock_wait", timings.lock_wait[i] );
+    write_timing( tmp, "build", timings.build[i] );
+    tmp << "\n";
+  }
+  auto log = OPEN_FLEXLOG( "log/packettimings.log", false );
+  FLEXLOG( log ) << tmp.str();
+  CLOSE_FLEXLOG( log );
 }
 }
 }
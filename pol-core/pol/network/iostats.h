@@ -7,6 +7,8 @@
 #define __IOSTATS_H
 
 #include <atomic>
+#include <cstddef>
+
 namespace Pol
 {
 namespace Network
@@ -22,9 +24,59 @@ public:
     std::atomic<unsigned int> bytes;
   };
 
+  // outgoing packets get coalesced per client and flushed with one vectored send
+  struct Flush
+  {
+    std::atomic<unsigned int> packets;
+    std::atomic<unsigned int> syscalls;
+    std::atomic<unsigned int> bytes;
+  };
+
+  // counts durations in power of two buckets, bucket i holds values below 2^i microseconds
+  // (the last bucket everything above)
+  struct LatencyHistogram
+  {
+    static const size_t BUCKETS = 24;
+    std::atomic<unsigned int> counts[BUCKETS];
+    std::atomic<unsigned long long> total_us;
+
+    void add( unsigned long long usecs );
+    void reset();
+    unsigned int count() const;
+    // upper bound of the bucket holding the given percentile, 0 if empty
+    unsigned long long percentile( unsigned int pct ) const;
+  };
+
+  // messages handled by the InboundQueueThread (pol.cfg QueueInboundMessages)
+  struct Inbound
+  {
+    std::atomic<unsigned int> messages;
+    std::atomic<unsigned int> batches;
+    LatencyHistogram queue_latency;  // from framing until the handler starts
+    LatencyHistogram lock_wait;      // for PolLock, once per batch
+  };
+
   Packet sent[256];
   Packet received[256];
+  Flush flush;
+  Inbound inbound;
 };
+
+// Timings per packet id. Incoming packets measure the handler and the wait for PolLock in front
+// of it, outgoing packets the time from requesting the packet object until it is sent first.
+struct PacketTimings
+{
+  PacketTimings();
+
+  IOStats::LatencyHistogram handler[256];
+  IOStats::LatencyHistogram lock_wait[256];
+  IOStats::LatencyHistogram build[256];
+
+  void reset();
+};
+
+// writes the packet ids with timings into log/packettimings.log (pol.cfg PacketTimingLog)
+void log_packet_timings();
 }
 }
 #endif
@@ -1,6 +1,9 @@
 #ifndef __PACKETHELPER_H
 #define __PACKETHELPER_H
 
+#include <chrono>
+#include <memory>
+
 #include "../globals/network.h"
 #include "client.h"
 #include "clienttransmit.h"
@@ -32,6 +35,11 @@ class PacketOut
 {
 private:
   T* pkt;
+  std::chrono::steady_clock::time_point requested;
+  mutable bool sent;
+  // last sent content, shared by every further client it is sent to as long as the buffer is
+  // unchanged. The first client gets a plain copy, most packets have just one recipient.
+  mutable PreparedPacketRef prepared;
 
 public:
   PacketOut();
@@ -44,6 +52,7 @@ public:
 
 template <class T>
 PacketOut<T>::PacketOut()
+    : requested( std::chrono::steady_clock::now() ), sent( false ), prepared()
 {
   pkt = RequestPacket<T>( T::ID, T::SUB );
 }
@@ -69,7 +78,20 @@ void PacketOut<T>::Send( Client* client, int len ) const
     return;
   if ( len == -1 )
     len = pkt->offset;
-  Core::networkManager.clientTransmit->AddToQueue( client, &pkt->buffer, len );
+  if ( !sent )
+  {
+    // first send, everything since the request counts as build time
+    Core::networkManager.packet_timings.build[T::ID].add(
+        std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() -
+                                                               requested )
+            .count() );
+    sent = true;
+    Core::networkManager.clientTransmit->AddToQueue( client, &pkt->buffer, len );
+    return;
+  }
+  if ( !prepared || !prepared->equals( &pkt->buffer, len ) )
+    prepared = std::make_shared<const PreparedPacket>( &pkt->buffer, len );
+  Core::networkManager.clientTransmit->AddToQueue( client, prepared );
 }
 
 template <class T>
@@ -2,8 +2,10 @@
 #define __PACKETINTERFACE_H
 
 #include "../../clib/rawtypes.h"
+#include <atomic>
 #include <map>
 #include <queue>
+#include <vector>
 
 namespace Pol
 {
@@ -37,6 +39,7 @@ public:
   virtual ~PacketQueue() = default;
 
 public:
+  // returns nullptr if the queue is empty
   virtual PacketInterface* GetNext( u8 id, u16 sub = 0 )
   {
     (void)id;
@@ -45,6 +48,13 @@ public:
     return nullptr;
   };
   virtual void Add( PacketInterface* pkt ) { (void)pkt; /*do nothing*/ };
+  // readds all given packets at once and clears the vector
+  virtual void Add( std::vector<PacketInterface*>& pkts )
+  {
+    for ( auto pkt : pkts )
+      Add( pkt );
+    pkts.clear();
+  };
   virtual size_t Count() const { return 0; };
   virtual bool HasSubs() const { return false; };
   virtual PacketInterfaceQueueMap* GetSubs() { return nullptr; };
@@ -55,7 +65,23 @@ public:
 typedef std::pair<u8, PacketQueue*> PacketQueuePair;
 typedef std::map<u8, PacketQueue*> PacketQueueMap;
 
+// usage of the packet objects of one packet id
+struct PacketPoolStats
+{
+  PacketPoolStats();
+  std::atomic<unsigned int> requests;
+  std::atomic<unsigned int> local_hits;  // served from the thread local cache
+  std::atomic<unsigned int> pool_hits;   // served from the shared queue
+  std::atomic<unsigned int> misses;      // newly created
+  std::atomic<int> outstanding;          // requested and not yet readded
+  std::atomic<int> peak_outstanding;
+};
+
 // singleton "holder" of packets !EntryPoint!
+// Every thread keeps a small cache of readded packets in front of the shared queues, so that
+// requesting and readding a packet usually doesn't touch the shared lock. Overflowing caches are
+// moved to the shared queue in batches. A thread caches for one instance at a time, estimateSize
+// includes the caches of all threads.
 class PacketsSingleton
 {
 public:
@@ -67,11 +93,14 @@ public:
 
 private:
   PacketQueueMap packets;
+  PacketQueue* queues[256];  // fast lookup of the entries in packets
+  PacketPoolStats stats[256];
 
 public:
   PacketInterface* getPacket( u8 id, u16 sub = 0 );
   void ReAddPacket( PacketInterface* pkt );
   PacketQueueMap* getPackets() { return &packets; };
+  const PacketPoolStats& getStats( u8 id ) const { return stats[id]; };
   size_t estimateSize() const;
 };
 }  // namespace Network
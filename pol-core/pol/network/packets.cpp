@@ -10,6 +10,9 @@
 
 #include "packets.h"
 
+#include <atomic>
+#include <stdexcept>
+
 #include "../../clib/rawtypes.h"
 #include "../../clib/spinlock.h"
 #include "packethelper.h"
@@ -24,6 +27,138 @@ namespace Network
 using namespace PktHelper;
 using namespace PacketWriterDefs;
 
+namespace
+{
+// bytes held by the caches of all threads, they are part of PacketsSingleton::estimateSize
+std::atomic<size_t> local_cached_size( 0 );
+
+// readded packets of the current thread, the packets are deleted when the thread ends.
+// Every thread with packets gets one (with the dedicated client threads one per client), so the
+// cache is kept small, larger packets always go back to the shared queue.
+class LocalPacketCache
+{
+public:
+  static const size_t MAX_CACHED = 8;  // per packet type
+  static const size_t MAX_CACHED_TOTAL = 16;
+  static const size_t MAX_CACHED_SIZE = 16 * 1024;  // estimateSize of all cached packets
+
+  LocalPacketCache() : _owner( nullptr ), _packets(), _subs(), _count( 0 ), _size( 0 ) {}
+  ~LocalPacketCache() { clear(); }
+  LocalPacketCache( const LocalPacketCache& ) = delete;
+  LocalPacketCache& operator=( const LocalPacketCache& ) = delete;
+
+  PacketInterface* take( const PacketsSingleton* owner, u8 id, u16 sub )
+  {
+    if ( _owner != owner || _count == 0 )
+      return nullptr;
+    std::vector<PacketInterface*>& pkts = get( id, sub );
+    if ( pkts.empty() )
+      return nullptr;
+    PacketInterface* pkt = pkts.back();
+    pkts.pop_back();
+    uncount( pkt );
+    return pkt;
+  }
+
+  // keeps the packet if there is room, half of the cached ones of the type are moved to the
+  // shared queue if there are too many
+  void put( const PacketsSingleton* owner, PacketInterface* pkt, PacketQueue* queue )
+  {
+    if ( _owner != owner )
+    {
+      // the cached packets belong to another pool
+      clear();
+      _owner = owner;
+    }
+    size_t size = pkt->estimateSize();
+    if ( _count >= MAX_CACHED_TOTAL || _size + size > MAX_CACHED_SIZE )
+    {
+      queue->Add( pkt );
+      return;
+    }
+    std::vector<PacketInterface*>& pkts = get( pkt->getID(), pkt->getSubID() );
+    pkts.push_back( pkt );
+    ++_count;
+    _size += size;
+    local_cached_size += size;
+    if ( pkts.size() > MAX_CACHED )
+    {
+      std::vector<PacketInterface*> batch( pkts.begin() + MAX_CACHED / 2, pkts.end() );
+      pkts.resize( MAX_CACHED / 2 );
+      for ( auto batch_pkt : batch )
+        uncount( batch_pkt );
+      queue->Add( batch );
+    }
+  }
+
+private:
+  struct SubEntry
+  {
+    u8 id;
+    u16 sub;
+    std::vector<PacketInterface*> pkts;
+  };
+
+  std::vector<PacketInterface*>& get( u8 id, u16 sub )
+  {
+    if ( sub == 0 )
+      return _packets[id];
+    // only a handful of sub packets exist
+    for ( auto& entry : _subs )
+    {
+      if ( entry.id == id && entry.sub == sub )
+        return entry.pkts;
+    }
+    _subs.push_back( SubEntry{id, sub, {}} );
+    return _subs.back().pkts;
+  }
+
+  void uncount( PacketInterface* pkt )
+  {
+    size_t size = pkt->estimateSize();
+    --_count;
+    _size -= size;
+    local_cached_size -= size;
+  }
+
+  void clear()
+  {
+    for ( auto& pkts : _packets )
+      clear( pkts );
+    for ( auto& entry : _subs )
+      clear( entry.pkts );
+  }
+
+  void clear( std::vector<PacketInterface*>& pkts )
+  {
+    for ( auto pkt : pkts )
+    {
+      uncount( pkt );
+      delete pkt;
+    }
+    pkts.clear();
+  }
+
+  const PacketsSingleton* _owner;
+  std::vector<PacketInterface*> _packets[256];
+  std::vector<SubEntry> _subs;
+  size_t _count;
+  size_t _size;
+};
+
+thread_local LocalPacketCache local_cache;
+}  // namespace
+
+PacketPoolStats::PacketPoolStats()
+    : requests( 0 ),
+      local_hits( 0 ),
+      pool_hits( 0 ),
+      misses( 0 ),
+      outstanding( 0 ),
+      peak_outstanding( 0 )
+{
+}
+
 /** @class PacketsSingleton
  * Central class that holds every pkt object
  *
@@ -117,11 +252,16 @@ PacketsSingleton::PacketsSingleton()
   packets.insert( PacketQueuePair( PKTOUT_DF_ID, new PacketQueueSingle() ) );
   packets.insert( PacketQueuePair( PKTOUT_E2_ID, new PacketQueueSingle() ) );
   packets.insert( PacketQueuePair( PKTOUT_E3_ID, new PacketQueueSingle() ) );
-  packets.insert( PacketQueuePair( PKTBI_F0_ID, new PacketQueueSingle() ) );
+  packets.insert( PacketQueuePair( PKTBI_F0_ID, new PacketQueueSubs() ) );
   packets.insert( PacketQueuePair( PKTOUT_F3_ID, new PacketQueueSingle() ) );
   packets.insert( PacketQueuePair( PKTOUT_F5_ID, new PacketQueueSingle() ) );
   packets.insert( PacketQueuePair( PKTOUT_F6_ID, new PacketQueueSingle() ) );
   packets.insert( PacketQueuePair( PKTOUT_F7_ID, new PacketQueueSingle() ) );
+
+  for ( auto& queue : queues )
+    queue = nullptr;
+  for ( const auto& pkts : packets )
+    queues[pkts.first] = pkts.second;
 }
 
 PacketsSingleton::~PacketsSingleton()
@@ -135,20 +275,46 @@ PacketsSingleton::~PacketsSingleton()
 
 PacketInterface* PacketsSingleton::getPacket( u8 id, u16 sub )
 {
-  PacketQueueMap::iterator itr = packets.find( id );
-  if ( itr != packets.end() )
-    return itr->second->GetNext( id, sub );
-  throw std::runtime_error( "Request of undefined Packet: " + Clib::hexint( id ) + "-" +
-                            Clib::hexint( sub ) );
+  PacketQueue* queue = queues[id];
+  if ( queue == nullptr )
+    throw std::runtime_error( "Request of undefined Packet: " + Clib::hexint( id ) + "-" +
+                              Clib::hexint( sub ) );
+  PacketPoolStats& stat = stats[id];
+  stat.requests.fetch_add( 1, std::memory_order_relaxed );
+  int outstanding = stat.outstanding.fetch_add( 1, std::memory_order_relaxed ) + 1;
+  int peak = stat.peak_outstanding.load( std::memory_order_relaxed );
+  while ( outstanding > peak &&
+          !stat.peak_outstanding.compare_exchange_weak( peak, outstanding,
+                                                        std::memory_order_relaxed ) )
+    ;
+
+  PacketInterface* pkt = local_cache.take( this, id, sub );
+  if ( pkt != nullptr )
+  {
+    stat.local_hits.fetch_add( 1, std::memory_order_relaxed );
+    pkt->ReSetBuffer();
+    return pkt;
+  }
+  pkt = queue->GetNext( id, sub );
+  if ( pkt != nullptr )
+  {
+    stat.pool_hits.fetch_add( 1, std::memory_order_relaxed );
+    return pkt;
+  }
+  stat.misses.fetch_add( 1, std::memory_order_relaxed );
+  return GetPacket( id, sub );
 }
 
 void PacketsSingleton::ReAddPacket( PacketInterface* pkt )
 {
-  PacketQueueMap::iterator itr = packets.find( pkt->getID() );
-  if ( itr != packets.end() )
-    itr->second->Add( pkt );
-  else
+  PacketQueue* queue = queues[pkt->getID()];
+  if ( queue == nullptr )
+  {
     delete pkt;
+    return;
+  }
+  stats[pkt->getID()].outstanding.fetch_sub( 1, std::memory_order_relaxed );
+  local_cache.put( this, pkt, queue );
 }
 
 size_t PacketsSingleton::estimateSize() const
@@ -159,25 +325,25 @@ size_t PacketsSingleton::estimateSize() const
     size += sizeof( pkts.first ) + ( sizeof( void* ) * 3 + 1 ) / 2;
     size += pkts.second->estimateSize();
   }
+  size += local_cached_size;
   return size;
 }
 
 PacketQueueSingle::PacketQueueSingle() : _packets(), _lock() {}
-PacketInterface* PacketQueueSingle::GetNext( u8 id, u16 /*sub*/ )
+PacketInterface* PacketQueueSingle::GetNext( u8 /*id*/, u16 /*sub*/ )
 {
-  // critical start
-  Clib::SpinLockGuard lock( _lock );
   PacketInterface* pkt;
-  if ( !_packets.empty() )
   {
+    // critical start
+    Clib::SpinLockGuard lock( _lock );
+    if ( _packets.empty() )
+      return nullptr;
     pkt = _packets.front();  // get next one
     _packets.pop();          // and remove it from queue
-    pkt->ReSetBuffer();
+    // critical end
   }
-  else
-    pkt = GetPacket( id );
+  pkt->ReSetBuffer();
   return pkt;
-  // critical end
 }
 
 PacketQueueSingle::~PacketQueueSingle()
@@ -202,6 +368,21 @@ void PacketQueueSingle::Add( PacketInterface* pkt )
   }
 }
 
+void PacketQueueSingle::Add( std::vector<PacketInterface*>& pkts )
+{
+  {
+    Clib::SpinLockGuard lock( _lock );
+    while ( !pkts.empty() && _packets.size() <= MAX_PACKETS_INSTANCES )
+    {
+      _packets.push( pkts.back() );
+      pkts.pop_back();
+    }
+  }
+  for ( auto pkt : pkts )  // enough
+    delete pkt;
+  pkts.clear();
+}
+
 size_t PacketQueueSingle::estimateSize() const
 {
   Clib::SpinLockGuard lock( _lock );
@@ -227,28 +408,21 @@ PacketQueueSubs::~PacketQueueSubs()
   _packets.clear();
 }
 
-PacketInterface* PacketQueueSubs::GetNext( u8 id, u16 sub )
+PacketInterface* PacketQueueSubs::GetNext( u8 /*id*/, u16 sub )
 {
-  // critical start
-  Clib::SpinLockGuard lock( _lock );
   PacketInterface* pkt;
-  if ( !_packets.empty() )
   {
+    // critical start
+    Clib::SpinLockGuard lock( _lock );
     PacketInterfaceQueueMap::iterator itr = _packets.find( sub );
-    if ( itr != _packets.end() )
-    {
-      if ( !itr->second.empty() )
-      {
-        pkt = itr->second.front();  // get next one
-        itr->second.pop();          // and remove it from queue
-        pkt->ReSetBuffer();
-        return pkt;
-      }
-    }
+    if ( itr == _packets.end() || itr->second.empty() )
+      return nullptr;
+    pkt = itr->second.front();  // get next one
+    itr->second.pop();          // and remove it from queue
+    // critical end
   }
-  pkt = GetPacket( id, sub );
+  pkt->ReSetBuffer();
   return pkt;
-  // critical end
 }
 
 void PacketQueueSubs::Add( PacketInterface* pkt )
@@ -273,6 +447,24 @@ void PacketQueueSubs::Add( PacketInterface* pkt )
   // critical end
 }
 
+void PacketQueueSubs::Add( std::vector<PacketInterface*>& pkts )
+{
+  {
+    Clib::SpinLockGuard lock( _lock );
+    while ( !pkts.empty() )
+    {
+      PacketInterfaceQueue& qu = _packets[pkts.back()->getSubID()];
+      if ( qu.size() > MAX_PACKETS_INSTANCES )  // enough?
+        break;
+      qu.push( pkts.back() );
+      pkts.pop_back();
+    }
+  }
+  for ( auto pkt : pkts )
+    delete pkt;
+  pkts.clear();
+}
+
 size_t PacketQueueSubs::Count() const
 {
   Clib::SpinLockGuard lock( _lock );
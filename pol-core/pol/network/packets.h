@@ -15,6 +15,7 @@
 #include <queue>
 #include <string.h>
 #include <type_traits>
+#include <vector>
 
 #include "../../clib/clib_endian.h"
 #include "../../clib/logfacility.h"
@@ -52,6 +53,7 @@ private:
 public:
   virtual PacketInterface* GetNext( u8 id, u16 sub = 0 ) override;
   virtual void Add( PacketInterface* pkt ) override;
+  virtual void Add( std::vector<PacketInterface*>& pkts ) override;
   virtual size_t Count() const override { return _packets.size(); };
   virtual size_t estimateSize() const override;
 };
@@ -70,6 +72,7 @@ private:
 public:
   virtual PacketInterface* GetNext( u8 id, u16 sub = 0 ) override;
   virtual void Add( PacketInterface* pkt ) override;
+  virtual void Add( std::vector<PacketInterface*>& pkts ) override;
   virtual size_t Count() const override;
   virtual bool HasSubs() const override { return true; };
   virtual PacketInterfaceQueueMap* GetSubs() override { return &_packets; };
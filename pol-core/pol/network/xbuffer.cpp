@@ -0,0 +1,86 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "xbuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Pol
+{
+namespace Core
+{
+XmitBuffer::XmitBuffer() : _data(), _head( 0 ), _size( 0 ) {}
+
+void XmitBuffer::append( const void* data, size_t len )
+{
+  if ( _size + len > _data.size() )
+    grow( _size + len );
+  const unsigned char* src = static_cast<const unsigned char*>( data );
+  size_t mask = _data.size() - 1;
+  size_t tail = ( _head + _size ) & mask;
+  size_t first = std::min( len, _data.size() - tail );
+  memcpy( &_data[tail], src, first );
+  if ( first < len )
+    memcpy( &_data[0], src + first, len - first );
+  _size += len;
+}
+
+int XmitBuffer::segments( const unsigned char* data[2], size_t len[2] ) const
+{
+  if ( _size == 0 )
+    return 0;
+  size_t first = std::min( _size, _data.size() - _head );
+  data[0] = &_data[_head];
+  len[0] = first;
+  if ( first == _size )
+    return 1;
+  data[1] = &_data[0];
+  len[1] = _size - first;
+  return 2;
+}
+
+void XmitBuffer::consume( size_t len )
+{
+  len = std::min( len, _size );
+  _size -= len;
+  if ( _size == 0 )
+  {
+    _head = 0;
+    if ( _data.size() > SHRINK_CAPACITY )
+      std::vector<unsigned char>().swap( _data );
+  }
+  else
+    _head = ( _head + len ) & ( _data.size() - 1 );
+}
+
+void XmitBuffer::clear()
+{
+  std::vector<unsigned char>().swap( _data );
+  _head = 0;
+  _size = 0;
+}
+
+void XmitBuffer::grow( size_t needed )
+{
+  size_t newcap = std::max( _data.size(), INITIAL_CAPACITY );
+  while ( newcap < needed )
+    newcap *= 2;
+  std::vector<unsigned char> newdata( newcap );
+  const unsigned char* seg[2];
+  size_t seglen[2];
+  int n = segments( seg, seglen );
+  size_t offset = 0;
+  for ( int i = 0; i < n; ++i )
+  {
+    memcpy( &newdata[offset], seg[i], seglen[i] );
+    offset += seglen[i];
+  }
+  _data.swap( newdata );
+  _head = 0;
+}
+}  // namespace Core
+}  // namespace Pol
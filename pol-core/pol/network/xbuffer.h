@@ -7,21 +7,43 @@
 #ifndef __XBUFFER_H
 #define __XBUFFER_H
 
-// Note on XmitBuffer: generally, 'lenleft' will start out as the number of data bytes,
-// and 'nsent' will start as 0.  As more data is sent, nsent will move to the original lenleft,
-// while lenleft will move to 0.
-// Also note that malloc/free are used to allocate this structure, since
-// data[] will be followed by (lenleft-1) more bytes, to house the data.
+#include <cstddef>
+#include <vector>
+
+// Note on XmitBuffer: all outgoing data of a client is appended into one contiguous ring buffer,
+// which gets flushed with a single vectored send (the pending data can wrap around the end of the
+// buffer, so at most two segments are handed to the socket).
+// The capacity is always a power of two and grows on demand, an empty buffer above
+// SHRINK_CAPACITY gets released again to not keep the memory of a backlog spike forever.
 namespace Pol
 {
 namespace Core
 {
-struct XmitBuffer
+class XmitBuffer
 {
-  XmitBuffer* next;
-  unsigned short nsent;    // how many bytes sent already
-  unsigned short lenleft;  // how many bytes left to send
-  unsigned char data[1];
+public:
+  static constexpr size_t INITIAL_CAPACITY = 4096;
+  static constexpr size_t SHRINK_CAPACITY = 65536;
+
+  XmitBuffer();
+
+  bool empty() const { return _size == 0; }
+  size_t size() const { return _size; }
+  size_t capacity() const { return _data.size(); }
+
+  void append( const void* data, size_t len );
+  // fills up to two segments of pending data in send order, returns the number of segments
+  int segments( const unsigned char* data[2], size_t len[2] ) const;
+  // removes len bytes from the front
+  void consume( size_t len );
+  void clear();
+
+private:
+  void grow( size_t needed );
+
+  std::vector<unsigned char> _data;
+  size_t _head;  // read position
+  size_t _size;  // pending bytes
 };
 }  // namespace Core
 }  // namespace Pol
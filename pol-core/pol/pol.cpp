@@ -110,6 +110,7 @@
 #include "network/clientthread.h"
 #include "network/clienttransmit.h"
 #include "network/cliface.h"
+#include "network/inboundqueue.h"
 #include "network/packethelper.h"
 #include "network/packethooks.h"
 #include "network/packets.h"
@@ -718,6 +719,8 @@ void threadstatus_thread( void )
         send_pulse();
         wake_tasks_thread();
         networkManager.clientTransmit->Cancel();
+        if ( networkManager.inboundQueue )
+          networkManager.inboundQueue->Cancel();
 #ifdef HAVE_MYSQL
         networkManager.sql_service->stop();
 #endif
@@ -811,8 +814,8 @@ void start_threads()
   checkpoint( "start threadstatus thread" );
   start_thread( threadstatus_thread, "ThreadStatus" );
 
-  checkpoint( "start clienttransmit thread" );
-  start_thread( Network::ClientTransmitThread, "ClientTransmit" );
+  checkpoint( "start clienttransmit threads" );
+  networkManager.clientTransmit->StartThreads();
 
 #ifdef HAVE_MYSQL
   checkpoint( "start sql service thread" );
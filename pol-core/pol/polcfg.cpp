@@ -95,6 +95,18 @@ void PolConfig::read_pol_config( bool initial_load )
 
     Plib::systemstate.config.debug_port = elem.remove_ushort( "DebugPort", 0 );
 
+    Plib::systemstate.config.network_reactor_threads =
+        elem.remove_ushort( "NetworkReactorThreads", 0 );
+    Plib::systemstate.config.transmit_threads = elem.remove_ushort( "TransmitThreads", 1 );
+    Plib::systemstate.config.queue_inbound_messages =
+        elem.remove_bool( "QueueInboundMessages", false );
+    Plib::systemstate.config.packet_timing_log = elem.remove_int( "PacketTimingLog", 0 );
+    if ( Plib::systemstate.config.packet_timing_log > 0 )
+    {
+      gamestate.log_packet_timings_task->set_secs( Plib::systemstate.config.packet_timing_log );
+      gamestate.log_packet_timings_task->start();
+    }
+
     Plib::systemstate.config.account_save = elem.remove_int( "AccountDataSave", -1 );
     if ( Plib::systemstate.config.account_save > 0 )
     {
@@ -89,6 +89,10 @@ struct PolConfig
 
   int account_save;
   bool use_single_thread_login;
+  unsigned short network_reactor_threads;
+  unsigned short transmit_threads;
+  bool queue_inbound_messages;
+  int packet_timing_log;
 
   bool disable_nagle;
   bool show_realm_info;
@@ -86,10 +86,12 @@ size_t Realm::sizeEstimate() const
   {
     for ( unsigned y = 0; y < gridheight; ++y )
     {
-      size += 3 * sizeof( void** ) + zone[x][y].characters.capacity() * sizeof( void* );
-      size += 3 * sizeof( void** ) + zone[x][y].npcs.capacity() * sizeof( void* );
-      size += 3 * sizeof( void** ) + zone[x][y].items.capacity() * sizeof( void* );
-      size += 3 * sizeof( void** ) + zone[x][y].multis.capacity() * sizeof( void* );
+      size += zone[x][y].characters.sizeEstimate();
+      size += zone[x][y].npcs.sizeEstimate();
+      size += zone[x][y].items.sizeEstimate();
+      size += zone[x][y].multis.sizeEstimate();
+      size += 3 * sizeof( void** ) + zone[x][y].online_players.capacity() * sizeof( void* );
+      size += 3 * sizeof( void** ) + zone[x][y].controlled_items.capacity() * sizeof( void* );
     }
   }
 
@@ -137,7 +139,7 @@ void Realm::notify_moved( Mobile::Character& whomoved )
         whomoved.lastx, whomoved.lasty, this, 32,
         [&]( Mobile::Character* chr ) { Mobile::NpcPropagateMove( chr, &whomoved ); } );
 
-    Core::WorldIterator<Core::ItemFilter>::InRange(
+    Core::WorldIterator<Core::ControlledItemFilter>::InRange(
         whomoved.lastx, whomoved.lasty, this, 32,
         [&]( Items::Item* item ) { item->inform_moved( &whomoved ); } );
   }
@@ -147,8 +149,8 @@ void Realm::notify_moved( Mobile::Character& whomoved )
       whomoved.x, whomoved.y, this, 33,
       [&]( Mobile::Character* chr ) { Mobile::NpcPropagateMove( chr, &whomoved ); } );
 
-  // the same for top-level items
-  Core::WorldIterator<Core::ItemFilter>::InRange(
+  // the same for top-level items, only the ones with a control script can react
+  Core::WorldIterator<Core::ControlledItemFilter>::InRange(
       whomoved.x, whomoved.y, this, 33,
       [&]( Items::Item* item ) { item->inform_moved( &whomoved ); } );
 }
@@ -161,7 +163,7 @@ void Realm::notify_unhid( Mobile::Character& whounhid )
       whounhid.x, whounhid.y, this, 32,
       [&]( Mobile::Character* chr ) { Mobile::NpcPropagateEnteredArea( chr, &whounhid ); } );
 
-  Core::WorldIterator<Core::ItemFilter>::InRange(
+  Core::WorldIterator<Core::ControlledItemFilter>::InRange(
       whounhid.x, whounhid.y, this, 32,
       [&]( Items::Item* item ) { item->inform_enteredarea( &whounhid ); } );
 }
@@ -183,7 +185,7 @@ void Realm::notify_entered( Mobile::Character& whoentered )
       } );
 
   // and notify the top-level items too
-  Core::WorldIterator<Core::ItemFilter>::InRange(
+  Core::WorldIterator<Core::ControlledItemFilter>::InRange(
       whoentered.x, whoentered.y, this, 32,
       [&]( Items::Item* item ) { item->inform_enteredarea( &whoentered ); } );
 }
@@ -195,7 +197,7 @@ void Realm::notify_left( Mobile::Character& wholeft )
       wholeft.x, wholeft.y, this, 32,
       [&]( Mobile::Character* chr ) { Mobile::NpcPropagateLeftArea( chr, &wholeft ); } );
 
-  Core::WorldIterator<Core::ItemFilter>::InRange(
+  Core::WorldIterator<Core::ControlledItemFilter>::InRange(
       wholeft.x, wholeft.y, this, 32,
       [&]( Items::Item* item ) { item->inform_leftarea( &wholeft ); } );
 }
@@ -72,38 +72,33 @@ void check_blocked( polclock_t* pclocksleft )
   polclock_t now_clock = polclock();
   stateManager.profilevars.sleep_cycles +=
       scriptScheduler.getHoldlist().size() + scriptScheduler.getNoTimeoutHoldlist().size();
-  polclock_t clocksleft = POLCLOCKS_PER_SEC * 60;
+  scriptScheduler.expire_timeouts( now_clock );
   for ( ;; )
   {
     THREAD_CHECKPOINT( scripts, 131 );
 
-    auto itr = scriptScheduler.getHoldlist().cbegin();
-    if ( itr == scriptScheduler.getHoldlist().cend() )
+    const HoldList::value_type* due = scriptScheduler.getHoldlist().due();
+    if ( due == nullptr )
       break;
 
-    UOExecutor* ex = ( *itr ).second;
+    UOExecutor* ex = due->second;
     // ++ex->sleep_cycles;
 
     passert( ex->blocked() );
     passert( ex->sleep_until_clock() != 0 );
-    clocksleft = ex->sleep_until_clock() - now_clock;
-    if ( clocksleft <= 0 )
-    {
-      if ( clocksleft == 0 )
-        INC_PROFILEVAR( scripts_ontime );
-      else
-        INC_PROFILEVAR( scripts_late );
-      // wakey-wakey
-      // read comment above to understand what goes on here.
-      // the return value is already on the stack.
-      THREAD_CHECKPOINT( scripts, 132 );
-      ex->revive();
-    }
+    if ( ex->sleep_until_clock() == now_clock )
+      INC_PROFILEVAR( scripts_ontime );
     else
-    {
-      break;
-    }
-  }
+      INC_PROFILEVAR( scripts_late );
+    // wakey-wakey
+    // read comment above to understand what goes on here.
+    // the return value is already on the stack.
+    THREAD_CHECKPOINT( scripts, 132 );
+    ex->revive();
+  }
+  polclock_t clocksleft = scriptScheduler.getHoldlist().next_expiry_bound() - now_clock;
+  if ( clocksleft > POLCLOCKS_PER_SEC * 60 )
+    clocksleft = POLCLOCKS_PER_SEC * 60;
   *pclocksleft = clocksleft;
 }
 
@@ -297,10 +292,10 @@ bool run_script_to_completion_worker( UOExecutor& ex, Bscript::EScriptProgram* p
   while ( ex.runnable() )
   {
     INFO_PRINT << ".";
-    for ( int i = 0; ( i < 1000 ) && ex.runnable(); i++ )
+    for ( unsigned int i = 0; ( i < 1000 ) && ex.runnable(); )
     {
       Clib::scripts_thread_scriptPC = ex.PC;
-      ex.execInstr();
+      i += ex.execInstrs( 1000 - i );
     }
   }
   INFO_PRINT << "\n";
@@ -341,7 +336,24 @@ bool run_script_to_completion( const char* filename )
 }
 
 
-Bscript::BObjectImp* run_executor_to_completion( UOExecutor& ex, const ScriptDef& script )
+namespace
+{
+// an executor of the ScriptScheduler pool, with all modules attached
+class PooledExecutor
+{
+public:
+  PooledExecutor() : ex_( scriptScheduler.acquire_executor() ) {}
+  ~PooledExecutor() { scriptScheduler.release_executor( ex_ ); }
+  PooledExecutor( const PooledExecutor& ) = delete;
+  PooledExecutor& operator=( const PooledExecutor& ) = delete;
+  UOExecutor& get() { return *ex_; }
+
+private:
+  UOExecutor* ex_;
+};
+
+// runs a script on an executor which already has its modules
+Bscript::BObjectImp* run_to_completion( UOExecutor& ex, const ScriptDef& script )
 {
   ref_ptr<Bscript::EScriptProgram> program = find_script2( script );
   if ( program.get() == nullptr )
@@ -350,9 +362,6 @@ Bscript::BObjectImp* run_executor_to_completion( UOExecutor& ex, const ScriptDef
     return new Bscript::BError( "Unable to read script" );
   }
 
-  add_common_exmods( ex );
-  ex.addModule( new Module::UOExecutorModule( ex ) );
-
   ex.setProgram( program.get() );
 
   ex.setDebugLevel( Bscript::Executor::NONE );
@@ -360,13 +369,13 @@ Bscript::BObjectImp* run_executor_to_completion( UOExecutor& ex, const ScriptDef
 
   Clib::scripts_thread_script = ex.scriptname();
 
-  int i = 0;
+  unsigned int i = 0;
   bool reported = false;
   while ( ex.runnable() )
   {
     Clib::scripts_thread_scriptPC = ex.PC;
-    ex.execInstr();
-    if ( ++i == 1000 )
+    i += ex.execInstrs( 1000 - i );
+    if ( i == 1000 )
     {
       if ( reported )
       {
@@ -393,12 +402,21 @@ Bscript::BObjectImp* run_executor_to_completion( UOExecutor& ex, const ScriptDef
   else
     return ex.ValueStack.back().get()->impptr()->copy();
 }
+}  // namespace
+
+Bscript::BObjectImp* run_executor_to_completion( UOExecutor& ex, const ScriptDef& script )
+{
+  add_common_exmods( ex );
+  ex.addModule( new Module::UOExecutorModule( ex ) );
+  return run_to_completion( ex, script );
+}
 
 Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script )
 {
-  UOExecutor ex;
+  PooledExecutor pooled;
+  UOExecutor& ex = pooled.get();
 
-  return run_executor_to_completion( ex, script );
+  return run_to_completion( ex, script );
 }
 
 
@@ -407,11 +425,12 @@ Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script,
 {
   //??    BObject bobj1( param1 );
 
-  UOExecutor ex;
+  PooledExecutor pooled;
+  UOExecutor& ex = pooled.get();
 
   ex.pushArg( param1 );
 
-  return run_executor_to_completion( ex, script );
+  return run_to_completion( ex, script );
 }
 
 
@@ -420,12 +439,13 @@ Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript:
 {
   //?? BObject bobj1( param1 ), bobj2( param2 );
 
-  UOExecutor ex;
+  PooledExecutor pooled;
+  UOExecutor& ex = pooled.get();
 
   ex.pushArg( param2 );
   ex.pushArg( param1 );
 
-  return run_executor_to_completion( ex, script );
+  return run_to_completion( ex, script );
 }
 
 Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript::BObjectImp* param1,
@@ -434,13 +454,14 @@ Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript:
 {
   //??    BObject bobj1( param1 ), bobj2( param2 ), bobj3( param3 );
 
-  UOExecutor ex;
+  PooledExecutor pooled;
+  UOExecutor& ex = pooled.get();
 
   ex.pushArg( param3 );
   ex.pushArg( param2 );
   ex.pushArg( param1 );
 
-  return run_executor_to_completion( ex, script );
+  return run_to_completion( ex, script );
 }
 
 Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript::BObjectImp* param1,
@@ -450,14 +471,15 @@ Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript:
 {
   //??BObject bobj1( param1 ), bobj2( param2 ), bobj3( param3 ), bobj4( param4 );
 
-  UOExecutor ex;
+  PooledExecutor pooled;
+  UOExecutor& ex = pooled.get();
 
   ex.pushArg( param4 );
   ex.pushArg( param3 );
   ex.pushArg( param2 );
   ex.pushArg( param1 );
 
-  return run_executor_to_completion( ex, script );
+  return run_to_completion( ex, script );
 }
 
 Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript::BObjectImp* param1,
@@ -469,7 +491,8 @@ Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript:
   //?? BObject bobj1( param1 ), bobj2( param2 ), bobj3( param3 ),
   //??   bobj4( param4 ), bobj5( param5 );
 
-  UOExecutor ex;
+  PooledExecutor pooled;
+  UOExecutor& ex = pooled.get();
 
   ex.pushArg( param5 );
   ex.pushArg( param4 );
@@ -477,7 +500,7 @@ Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript:
   ex.pushArg( param2 );
   ex.pushArg( param1 );
 
-  return run_executor_to_completion( ex, script );
+  return run_to_completion( ex, script );
 }
 
 Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript::BObjectImp* param1,
@@ -490,7 +513,8 @@ Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript:
   //?? BObject bobj1( param1 ), bobj2( param2 ), bobj3( param3 ),
   //??   bobj4( param4 ), bobj5( param5 );
 
-  UOExecutor ex;
+  PooledExecutor pooled;
+  UOExecutor& ex = pooled.get();
 
   ex.pushArg( param6 );
   ex.pushArg( param5 );
@@ -499,7 +523,7 @@ Bscript::BObjectImp* run_script_to_completion( const ScriptDef& script, Bscript:
   ex.pushArg( param2 );
   ex.pushArg( param1 );
 
-  return run_executor_to_completion( ex, script );
+  return run_to_completion( ex, script );
 }
 
 Bscript::BObjectImp* run_script_to_completion(
@@ -507,7 +531,8 @@ Bscript::BObjectImp* run_script_to_completion(
     Bscript::BObjectImp* param3, Bscript::BObjectImp* param4, Bscript::BObjectImp* param5,
     Bscript::BObjectImp* param6, Bscript::BObjectImp* param7 )
 {
-  UOExecutor ex;
+  PooledExecutor pooled;
+  UOExecutor& ex = pooled.get();
 
   ex.pushArg( param7 );
   ex.pushArg( param6 );
@@ -517,7 +542,7 @@ Bscript::BObjectImp* run_script_to_completion(
   ex.pushArg( param2 );
   ex.pushArg( param1 );
 
-  return run_executor_to_completion( ex, script );
+  return run_to_completion( ex, script );
 }
 
 bool call_script( const ScriptDef& script, Bscript::BObjectImp* param0 )
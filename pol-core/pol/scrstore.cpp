@@ -7,7 +7,12 @@
 
 #include "scrstore.h"
 
+#include <ctime>
+#include <sstream>
+
 #include "../bscript/eprog.h"
+#include "../bscript/scriptsampler.h"
+#include "../clib/clib.h"
 #include "../clib/logfacility.h"
 #include "../clib/rawtypes.h"
 #include "../clib/strutil.h"
@@ -203,5 +208,34 @@ void clear_script_profile_counters()
 
   POLLOG << "Profiling counters cleared.\n";
 }
+
+void start_script_sampling( unsigned int samples_per_second )
+{
+  Bscript::script_sampler.start( samples_per_second );
+  POLLOG.Format( "Script sampling started, {} samples per second of script time.\n" )
+      << samples_per_second;
+}
+
+// stops the sampler and writes the collected stacks into a new file in log/, returns its name
+std::string stop_script_sampling()
+{
+  Bscript::script_sampler.stop();
+
+  char buffer[30];
+  auto time_tm = Clib::localtime( time( nullptr ) );
+  strftime( buffer, sizeof buffer, "%Y%m%d-%H%M%S", &time_tm );
+  std::string filename = std::string( "log/scriptsamples-" ) + buffer + ".txt";
+
+  std::ostringstream stacks;
+  Bscript::script_sampler.write( stacks );
+  auto log = OPEN_FLEXLOG( filename, false );
+  FLEXLOG( log ) << stacks.str();
+  CLOSE_FLEXLOG( log );
+
+  POLLOG.Format( "Script sampling stopped, {} samples written to {}\n" )
+      << Bscript::script_sampler.samples() << filename;
+  Bscript::script_sampler.clear();
+  return filename;
+}
 }  // namespace Core
 }  // namespace Pol
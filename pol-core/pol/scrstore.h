@@ -35,6 +35,8 @@ int unload_script( const std::string& name );
 int unload_all_scripts();  // returns # of scripts unloaded
 void log_all_script_cycle_counts( bool clear_counters );
 void clear_script_profile_counters();
+void start_script_sampling( unsigned int samples_per_second );
+std::string stop_script_sampling();
 
 bool script_loaded( ScriptDef& sd );
 }
@@ -35,6 +35,19 @@ void run_pol_tests()
 //  map_test();
 //  dynprops_test();
   packet_test();
+  huffman_test();
+  huffman_decode_test();
+  prepared_packet_test();
+  xmit_buffer_test();
+  latency_histogram_test();
+  packet_timings_test();
+  packet_pool_test();
+  inline_cache_test();
+  timer_wheel_test();
+  newly_inrange_test();
+  zone_coords_test();
+  online_players_test();
+  controlled_items_test();
   dummy();
   display_test_results();
 }
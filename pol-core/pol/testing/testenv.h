@@ -48,6 +48,19 @@ void los_test();
 void dynprops_test();
 void dummy();
 void packet_test();
+void huffman_test();
+void huffman_decode_test();
+void prepared_packet_test();
+void xmit_buffer_test();
+void latency_histogram_test();
+void packet_timings_test();
+void packet_pool_test();
+void inline_cache_test();
+void timer_wheel_test();
+void newly_inrange_test();
+void zone_coords_test();
+void online_players_test();
+void controlled_items_test();
 }
 }
 #endif
@@ -6,15 +6,35 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
+#include "pol_global_config.h"
+
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+#include "../../bscript/bobject.h"
+#include "../../bscript/escriptv.h"
+#include "../../bscript/executortype.h"
+#include "../../bscript/objmembers.h"
 #include "../../clib/logfacility.h"
 #include "../../clib/rawtypes.h"
+#include "../../clib/timerwheel.h"
 #include "../../plib/maptile.h"
 #include "../dynproperties.h"
 #include "../globals/uvars.h"
+#include "../item/item.h"
 #include "../network/packethelper.h"
 #include "../realms/realm.h"
+#include "../reftypes.h"
+#include "../ufunc.h"
+#include "../uworld.h"
+#include "testenv.h"
 
 namespace Pol
 {
@@ -53,6 +73,309 @@ void dynprops_test()
   INFO_PRINT << "size " << h.estimateSizeDynProps() << "\n";
 }
 
+void inline_cache_test()
+{
+  using namespace Bscript;
+  Items::Item* item = add_item( 0xe75, 1340, 1650, 50 );
+  // UObject, Item and no member at all
+  bool ok = true;
+  for ( int id : {MBR_X, MBR_AMOUNT, MBR_WARMODE} )
+  {
+    InlineCache cache;
+    u64 hits = escript_inline_cache_hits;
+    for ( int i = 0; i < 3; ++i )
+    {
+      std::unique_ptr<BObjectImp> cached( item->get_script_member_id_cached( id, cache ) );
+      std::unique_ptr<BObjectImp> uncached( item->get_script_member_id( id ) );
+      if ( cached && uncached )
+        ok = ok && *cached == *uncached;
+      else
+        ok = ok && !cached && !uncached;
+    }
+    ok = ok && cache.receiver != nullptr && escript_inline_cache_hits == hits + 2;
+  }
+  Core::destroy_item( item );
+
+  INFO_PRINT << "inline cache: ";
+  if ( ok )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void newly_inrange_test()
+{
+  std::vector<Items::Item*> items;
+  for ( unsigned short x = 2000; x < 2080; x += 3 )
+  {
+    for ( unsigned short y = 2000; y < 2080; y += 3 )
+      items.push_back( add_item( 0xe75, x, y, 0 ) );
+  }
+  auto realm = Core::gamestate.main_realm;
+  const unsigned short cx = 2040;
+  const unsigned short cy = 2040;
+  bool ok = true;
+  // single steps, runs, teleports over a part of the range and out of it
+  for ( int dx : {0, 1, -1, 2, -5, 20, -36, 37, 50} )
+  {
+    for ( int dy : {0, 1, -1, 3, -18, 36, -37, 45} )
+    {
+      unsigned short oldx = static_cast<unsigned short>( cx - dx );
+      unsigned short oldy = static_cast<unsigned short>( cy - dy );
+      std::multiset<Items::Item*> expected, visited;
+      Core::WorldIterator<Core::ItemFilter>::InRange(
+          cx, cy, realm, RANGE_VISUAL, [&]( Items::Item* item ) {
+            if ( !Core::inrange( item->x, item->y, oldx, oldy ) )
+              expected.insert( item );
+          } );
+      Core::WorldIterator<Core::ItemFilter>::NewlyInRange(
+          cx, cy, oldx, oldy, realm, RANGE_VISUAL,
+          [&]( Items::Item* item ) { visited.insert( item ); } );
+      ok = ok && expected == visited;
+    }
+  }
+  for ( auto item : items )
+    Core::destroy_item( item );
+
+  INFO_PRINT << "newly in range: ";
+  if ( ok )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void zone_coords_test()
+{
+  auto realm = Core::gamestate.main_realm;
+  Items::Item* item = add_item( 0xe75, 2100, 2100, 0 );
+  auto count_at = [&]( unsigned short x, unsigned short y ) {
+    int count = 0;
+    Core::WorldIterator<Core::ItemFilter>::InBox( x, y, x, y, realm, [&]( Items::Item* found ) {
+      if ( found == item )
+        ++count;
+    } );
+    return count;
+  };
+  bool ok = count_at( 2100, 2100 ) == 1;
+  // inside of the zone
+  Core::move_item( item, 2101, 2102, 0, realm );
+  ok = ok && count_at( 2100, 2100 ) == 0 && count_at( 2101, 2102 ) == 1;
+  // into another zone
+  Core::move_item( item, 2200, 2190, 0, realm );
+  ok = ok && count_at( 2101, 2102 ) == 0 && count_at( 2200, 2190 ) == 1;
+  Core::destroy_item( item );
+  ok = ok && count_at( 2200, 2190 ) == 0;
+
+  // removing from the middle of a zone moves the last item into the free slot
+  std::vector<Items::Item*> neighbours;
+  for ( unsigned short i = 0; i < 4; ++i )
+    neighbours.push_back( add_item( 0xe75, 2110 + i, 2110, 0 ) );
+  Core::move_item( neighbours[1], 2300, 2300, 0, realm );
+  item = neighbours[0];
+  Core::destroy_item( item );
+  ok = ok && count_at( 2110, 2110 ) == 0;
+  Core::move_item( neighbours[3], 2111, 2111, 0, realm );
+  for ( size_t i = 1; i < neighbours.size(); ++i )
+  {
+    item = neighbours[i];
+    ok = ok && count_at( item->x, item->y ) == 1;
+    Core::destroy_item( item );
+  }
+
+  INFO_PRINT << "zone coordinates: ";
+  if ( ok )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void online_players_test()
+{
+  auto realm = Core::gamestate.main_realm;
+  auto online_in = [&]( unsigned short x, unsigned short y, const Mobile::Character* chr ) {
+    const auto& players = Core::getzone( x, y, realm ).online_players;
+    return std::count( players.begin(), players.end(), chr );
+  };
+  Core::CharacterRef chr( new Mobile::Character( 0x190 ) );
+  chr->realm = realm;
+  chr->x = 2100;
+  chr->y = 2100;
+  // connecting before entering the world, e.g. while a character gets created
+  chr->connected( true );
+  bool ok = online_in( 2100, 2100, chr.get() ) == 0;
+  Core::SetCharacterWorldPosition( chr.get(), Realms::WorldChangeReason::PlayerEnter );
+  ok = ok && online_in( 2100, 2100, chr.get() ) == 1;
+  Core::MoveCharacterWorldPosition( 2100, 2100, 2200, 2200, chr.get(), nullptr );
+  chr->x = 2200;
+  chr->y = 2200;
+  ok = ok && online_in( 2100, 2100, chr.get() ) == 0 && online_in( 2200, 2200, chr.get() ) == 1;
+  // lingering after the client disconnected
+  chr->connected( false );
+  ok = ok && online_in( 2200, 2200, chr.get() ) == 0;
+  chr->connected( true );
+  ok = ok && online_in( 2200, 2200, chr.get() ) == 1;
+  Core::ClrCharacterWorldPosition( chr.get(), Realms::WorldChangeReason::PlayerExit );
+  ok = ok && online_in( 2200, 2200, chr.get() ) == 0;
+  chr->connected( false );
+  chr->logged_in( false );
+
+  INFO_PRINT << "online players: ";
+  if ( ok )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void controlled_items_test()
+{
+  auto realm = Core::gamestate.main_realm;
+  auto controlled_in = [&]( unsigned short x, unsigned short y, const Items::Item* item ) {
+    const auto& items = Core::getzone( x, y, realm ).controlled_items;
+    return std::count( items.begin(), items.end(), item );
+  };
+  auto listed_once = [&]( const Items::Item* item ) {
+    const auto& zone = Core::getzone( item->x, item->y, realm );
+    return zone.items.contains( item ) &&
+           std::count( zone.controlled_items.begin(), zone.controlled_items.end(), item ) == 1;
+  };
+  // never dereferenced by the world functions used here
+  int dummy_process;
+  auto process = reinterpret_cast<Module::UOExecutorModule*>( &dummy_process );
+
+  std::vector<Items::Item*> controlled;
+  for ( unsigned short i = 0; i < 4; ++i )
+  {
+    Items::Item* item = add_item( 0xe75, 2400 + i, 2400, 0 );
+    item->process( process );
+    Core::UpdateItemControlZone( item );
+    controlled.push_back( item );
+  }
+  Items::Item* uncontrolled = add_item( 0xe75, 2404, 2400, 0 );
+  bool ok = controlled_in( 2404, 2400, uncontrolled ) == 0;
+  for ( const auto& item : controlled )
+    ok = ok && listed_once( item );
+
+  // into another zone
+  Core::move_item( controlled[1], 2500, 2500, 0, realm );
+  ok = ok && controlled_in( 2400, 2400, controlled[1] ) == 0 && listed_once( controlled[1] );
+  // removing from the middle of the zone moves the last items into the free slots
+  Core::destroy_item( controlled[2] );
+  ok = ok && controlled_in( 2400, 2400, controlled[2] ) == 0 &&
+       Core::getzone( 2400, 2400, realm ).controlled_items.size() == 2;
+  controlled.erase( controlled.begin() + 2 );
+  for ( const auto& item : controlled )
+    ok = ok && listed_once( item );
+  ok = ok && Core::getzone( 2404, 2400, realm ).items.contains( uncontrolled );
+
+  // losing the control script
+  controlled[0]->process( nullptr );
+  Core::UpdateItemControlZone( controlled[0] );
+  ok = ok && controlled_in( 2400, 2400, controlled[0] ) == 0 &&
+       Core::getzone( 2400, 2400, realm ).items.contains( controlled[0] ) &&
+       listed_once( controlled[2] );
+
+  for ( const auto& item : controlled )
+  {
+    item->process( nullptr );
+    Core::destroy_item( item );
+  }
+  Core::destroy_item( uncontrolled );
+  ok = ok && Core::getzone( 2400, 2400, realm ).controlled_items.empty() &&
+       Core::getzone( 2500, 2500, realm ).controlled_items.empty();
+
+  INFO_PRINT << "controlled items: ";
+  if ( ok )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void timer_wheel_test()
+{
+  typedef Clib::TimerWheel<int> Wheel;
+  // expiries within every level, in the overflow list and in the past
+  std::vector<Wheel::Tick> expiries = {5,     1,    63,       64,       65,      4095, 4096,
+                                       4097,  5,    262143,   262144,   300000,  0,    -7,
+                                       16777215, 16777216, 20000000, 70000000, 1000};
+  Wheel wheel( 1 );
+  std::vector<Wheel::Handle> handles;
+  for ( size_t i = 0; i < expiries.size(); ++i )
+    handles.push_back( wheel.insert( expiries[i], static_cast<int>( i ) ) );
+  // erased entries never expire
+  wheel.erase( handles[18] );
+  wheel.erase( handles[3] );
+
+  bool ok = wheel.size() == expiries.size() - 2;
+  std::vector<int> expired;
+  Wheel::Tick now = 1;
+  while ( !wheel.empty() && ok )
+  {
+    Wheel::Tick bound = wheel.next_expiry_bound();
+    ok = bound >= now;
+    now = std::max( now, bound );
+    wheel.advance( now );
+    while ( const Wheel::value_type* entry = wheel.due() )
+    {
+      // never late, and nothing expires early
+      ok = ok && entry->first <= now && ( entry->first >= now || entry->first <= 1 );
+      expired.push_back( entry->second );
+      wheel.erase( wheel.due_handle() );
+    }
+  }
+  // same expiry in insertion order
+  std::vector<int> expected = {1, 12, 13, 0, 8, 2, 4, 5, 6, 7, 9, 10, 11, 14, 15, 16, 17};
+  ok = ok && expired == expected && wheel.begin() == wheel.end();
+
+  // handles of erased entries get reused
+  Wheel::Handle handle = wheel.insert( now + 10, 42 );
+  ok = ok && handle < handles.size();
+  ok = ok && wheel.begin()->second == 42 && wheel.size() == 1;
+  wheel.clear();
+  ok = ok && wheel.empty() && wheel.due() == nullptr;
+
+  INFO_PRINT << "timer wheel: ";
+  if ( ok )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
 void packet_test()
 {
   using namespace Network;
@@ -134,5 +457,117 @@ void packet_test()
   }
 }
 
+#ifdef ENABLE_BENCHMARK
+// sleeping scripts as the scheduler sees them: every script wakes up and goes to sleep again
+static std::vector<s64> sleep_durations( size_t count )
+{
+  std::vector<s64> durations( count );
+  u32 seed = 12345;
+  for ( auto& duration : durations )
+  {
+    seed = seed * 1103515245 + 12345;
+    duration = 1 + ( seed >> 8 ) % 6000;  // up to a minute in polclocks
+  }
+  return durations;
+}
+
+static void BM_holdlist_multimap( benchmark::State& state )
+{
+  auto durations = sleep_durations( static_cast<size_t>( state.range( 0 ) ) );
+  std::multimap<s64, size_t> holdlist;
+  for ( size_t i = 0; i < durations.size(); ++i )
+    holdlist.insert( std::make_pair( durations[i], i ) );
+  s64 now = 0;
+  while ( state.KeepRunning() )
+  {
+    ++now;
+    auto itr = holdlist.begin();
+    while ( itr != holdlist.end() && itr->first <= now )
+    {
+      size_t script = itr->second;
+      holdlist.erase( itr );
+      holdlist.insert( std::make_pair( now + durations[script], script ) );
+      itr = holdlist.begin();
+    }
+  }
+}
+BENCHMARK( BM_holdlist_multimap )->Arg( 10000 )->Arg( 50000 )->Arg( 100000 );
+
+static void BM_holdlist_timerwheel( benchmark::State& state )
+{
+  auto durations = sleep_durations( static_cast<size_t>( state.range( 0 ) ) );
+  Clib::TimerWheel<size_t> holdlist;
+  for ( size_t i = 0; i < durations.size(); ++i )
+    holdlist.insert( durations[i], i );
+  s64 now = 0;
+  while ( state.KeepRunning() )
+  {
+    ++now;
+    holdlist.advance( now );
+    while ( const Clib::TimerWheel<size_t>::value_type* entry = holdlist.due() )
+    {
+      size_t script = entry->second;
+      holdlist.erase( holdlist.due_handle() );
+      holdlist.insert( now + durations[script], script );
+    }
+  }
+}
+BENCHMARK( BM_holdlist_timerwheel )->Arg( 10000 )->Arg( 50000 )->Arg( 100000 );
+// items spread over a 512x512 area of the test realm, range(0) per zone
+static std::vector<Items::Item*> add_item_field( size_t per_zone )
+{
+  const unsigned short base = 1024;
+  const unsigned short size = 512;
+  size_t count = per_zone * ( size / Plib::WGRID_SIZE ) * ( size / Plib::WGRID_SIZE );
+  std::vector<Items::Item*> items;
+  u32 seed = 4711;
+  for ( size_t i = 0; i < count; ++i )
+  {
+    seed = seed * 1103515245 + 12345;
+    unsigned short x = static_cast<unsigned short>( base + ( seed >> 8 ) % size );
+    seed = seed * 1103515245 + 12345;
+    unsigned short y = static_cast<unsigned short>( base + ( seed >> 8 ) % size );
+    items.push_back( add_item( 0xe75, x, y, 0 ) );
+  }
+  return items;
+}
+
+static void BM_zone_inrange( benchmark::State& state )
+{
+  auto items = add_item_field( static_cast<size_t>( state.range( 0 ) ) );
+  auto realm = Core::gamestate.main_realm;
+  unsigned short x = 1100;
+  size_t found = 0;
+  while ( state.KeepRunning() )
+  {
+    x = x < 1460 ? x + 1 : 1100;
+    Core::WorldIterator<Core::ItemFilter>::InRange( x, 1300, realm, RANGE_VISUAL,
+                                                   [&]( Items::Item* ) { ++found; } );
+  }
+  benchmark::DoNotOptimize( found );
+  for ( auto item : items )
+    Core::destroy_item( item );
+}
+BENCHMARK( BM_zone_inrange )->Arg( 50 )->Arg( 500 )->Arg( 2000 );
+
+static void BM_zone_inbox( benchmark::State& state )
+{
+  auto items = add_item_field( static_cast<size_t>( state.range( 0 ) ) );
+  auto realm = Core::gamestate.main_realm;
+  unsigned short x = 1100;
+  size_t found = 0;
+  while ( state.KeepRunning() )
+  {
+    x = x < 1400 ? x + 1 : 1100;
+    // a house footprint
+    Core::WorldIterator<Core::ItemFilter>::InBox( x, 1300, x + 10, 1314, realm,
+                                                 [&]( Items::Item* ) { ++found; } );
+  }
+  benchmark::DoNotOptimize( found );
+  for ( auto item : items )
+    Core::destroy_item( item );
+}
+BENCHMARK( BM_zone_inbox )->Arg( 50 )->Arg( 500 )->Arg( 2000 );
+#endif
 }  // namespace Testing
 }  // namespace Pol
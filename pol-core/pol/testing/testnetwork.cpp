@@ -0,0 +1,398 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "testenv.h"
+
+#include "pol_global_config.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef ENABLE_BENCHMARK
+#include <benchmark/benchmark.h>
+#endif
+
+#include "../../clib/logfacility.h"
+#include "../../clib/random.h"
+#include "../../clib/rawtypes.h"
+#include "../ctable.h"
+#include "../network/clienttransmit.h"
+#include "../network/iostats.h"
+#include "../network/packets.h"
+#include "../network/pktinid.h"
+#include "../network/xbuffer.h"
+#include <format/format.h>
+
+namespace Pol
+{
+namespace Testing
+{
+namespace
+{
+// the former bit by bit encoder of ThreadedClient::transmit_encrypted, used as reference
+size_t huffman_compress_bitwise( const unsigned char* data, size_t len, unsigned char* out )
+{
+  unsigned char* pch = out;
+  int bidx = 0;
+  auto append = [&]( const Core::SVR_KEYDESC& key ) {
+    int nbits = key.nbits;
+    unsigned short inval = key.bits_reversed;
+    while ( nbits-- )
+    {
+      *pch <<= 1;
+      if ( inval & 1 )
+        *pch |= 1;
+      if ( ++bidx == 8 )
+      {
+        ++pch;
+        bidx = 0;
+      }
+      inval >>= 1;
+    }
+  };
+  for ( size_t i = 0; i < len; ++i )
+    append( Core::keydesc[data[i]] );
+  append( Core::keydesc[0x100] );
+  if ( bidx == 0 )
+    --pch;
+  else
+    *pch <<= ( 8 - bidx );
+  return pch - out + 1;
+}
+
+// synthetic server packets of a busy screen, hand-built after the packet layouts
+std::vector<std::vector<u8>> sample_packets()
+{
+  std::vector<std::vector<u8>> packets;
+  // 0x77 mobile moving
+  packets.push_back( {0x77, 0x00, 0x01, 0xa2, 0x3f, 0x01, 0x90, 0x05, 0x8a, 0x06, 0x4e, 0x00, 0x86,
+                      0x83, 0xea, 0x00, 0x01} );
+  // 0x1A item (stacked gold)
+  packets.push_back( {0x1a, 0x00, 0x10, 0xc0, 0x3b, 0x1e, 0x33, 0x0e, 0xed, 0x00, 0x64, 0x85, 0x8a,
+                      0x46, 0x4f, 0x00, 0x00} );
+  // 0xAE unicode speech
+  {
+    std::vector<u8> p = {0xae, 0x00, 0x00, 0x00, 0x01, 0xa2, 0x3f, 0x01, 0x90, 0x00, 0x00, 0x34,
+                         0x00, 0x03, 'E',  'N',  'U',  0x00};
+    p.resize( 48, 0 );
+    std::string text( "Vendor buy. Bank. Guards! Kal Vas Flam" );
+    for ( char c : text )
+    {
+      p.push_back( 0x00 );
+      p.push_back( static_cast<u8>( c ) );
+    }
+    p.push_back( 0x00 );
+    p.push_back( 0x00 );
+    p[1] = static_cast<u8>( p.size() >> 8 );
+    p[2] = static_cast<u8>( p.size() );
+    packets.push_back( p );
+  }
+  // 0xB0 gump layout
+  {
+    std::vector<u8> p = {0xb0, 0x00, 0x00, 0x00, 0x01, 0xa2, 0x3f, 0x00, 0x00,
+                         0x01, 0x2c, 0x00, 0x00, 0x00, 0x32, 0x00, 0x00, 0x00,
+                         0x32, 0x00, 0x00};
+    std::string layout( "{ page 0 }{ resizepic 0 0 9200 400 300 }" );
+    for ( int i = 0; i < 40; ++i )
+      layout += "{ button 20 " + std::to_string( 20 + i * 20 ) + " 4005 4007 1 0 " +
+                std::to_string( i + 1 ) + " }{ text 55 " + std::to_string( 20 + i * 20 ) +
+                " 1153 " + std::to_string( i ) + " }";
+    p.insert( p.end(), layout.begin(), layout.end() );
+    p.push_back( 0x00 );
+    p[1] = static_cast<u8>( p.size() >> 8 );
+    p[2] = static_cast<u8>( p.size() );
+    packets.push_back( p );
+  }
+  return packets;
+}
+
+void test_huffman( const std::vector<u8>& data )
+{
+  std::vector<unsigned char> expected( data.size() * 2 + 2 );
+  std::vector<unsigned char> result( data.size() * 2 + 2 );
+  size_t expected_len = huffman_compress_bitwise( data.data(), data.size(), expected.data() );
+  size_t result_len =
+      Core::huffman_compress( data.data(), data.size(), result.data(), result.size() );
+
+  INFO_PRINT << "huffman " << data.size() << " bytes: ";
+  if ( expected_len == result_len &&
+       std::equal( expected.begin(), expected.begin() + expected_len, result.begin() ) )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+}  // namespace
+
+void huffman_test()
+{
+  for ( const auto& packet : sample_packets() )
+    test_huffman( packet );
+  // every code length combination once, and odd trailing bit counts
+  for ( size_t len = 0; len < 64; ++len )
+  {
+    std::vector<u8> data( len );
+    for ( auto& c : data )
+      c = static_cast<u8>( Clib::random_int( 255 ) );
+    test_huffman( data );
+  }
+  std::vector<u8> all( 256 );
+  for ( size_t i = 0; i < all.size(); ++i )
+    all[i] = static_cast<u8>( i );
+  test_huffman( all );
+
+  // too small output buffer has to be rejected
+  unsigned char out[4];
+  INFO_PRINT << "huffman overflow: ";
+  if ( Core::huffman_compress( all.data(), all.size(), out, sizeof out ) == 0 )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void huffman_decode_test()
+{
+  // the compressed packets back to back, fed in odd sized pieces like they arrive from a socket
+  auto packets = sample_packets();
+  std::vector<unsigned char> stream;
+  for ( const auto& packet : packets )
+  {
+    std::vector<unsigned char> out( packet.size() * 2 + 2 );
+    size_t len = Core::huffman_compress( packet.data(), packet.size(), out.data(), out.size() );
+    stream.insert( stream.end(), out.begin(), out.begin() + len );
+  }
+  Core::HuffmanDecoder decoder;
+  std::vector<std::vector<unsigned char>> decoded;
+  bool ok = true;
+  for ( size_t pos = 0; pos < stream.size(); pos += 7 )
+    ok = ok && decoder.decode( &stream[pos], std::min<size_t>( 7, stream.size() - pos ), &decoded );
+
+  INFO_PRINT << "huffman decode: ";
+  if ( ok && decoded == packets )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void prepared_packet_test()
+{
+  for ( const auto& packet : sample_packets() )
+  {
+    Network::PreparedPacket prepared( packet.data(), static_cast<int>( packet.size() ) );
+    std::vector<unsigned char> expected( packet.size() * 2 + 2 );
+    size_t expected_len =
+        huffman_compress_bitwise( packet.data(), packet.size(), expected.data() );
+    const auto& compressed = prepared.compressed();
+
+    INFO_PRINT << "prepared packet 0x" << fmt::hexu( packet[0] ) << ": ";
+    if ( prepared.equals( packet.data(), static_cast<int>( packet.size() ) ) &&
+         !prepared.equals( packet.data(), static_cast<int>( packet.size() ) - 1 ) &&
+         compressed.size() == expected_len &&
+         std::equal( compressed.begin(), compressed.end(), expected.begin() ) &&
+         &compressed == &prepared.compressed() )
+    {
+      INFO_PRINT << "Ok!\n";
+      inc_successes();
+    }
+    else
+    {
+      INFO_PRINT << "Failure!\n";
+      inc_failures();
+    }
+  }
+}
+
+void xmit_buffer_test()
+{
+  // push data through the ring in odd sized chunks, so that it wraps around and grows
+  Core::XmitBuffer xbuffer;
+  std::vector<u8> sent;
+  std::vector<u8> received;
+  u8 next = 0;
+  for ( size_t round = 0; round < 200; ++round )
+  {
+    std::vector<u8> chunk( ( round * 37 ) % 3000 + 1 );
+    for ( auto& c : chunk )
+      c = next++;
+    xbuffer.append( chunk.data(), chunk.size() );
+    sent.insert( sent.end(), chunk.begin(), chunk.end() );
+
+    const unsigned char* seg[2];
+    size_t seglen[2];
+    int nseg = xbuffer.segments( seg, seglen );
+    // consume only a part to keep data pending, like a partial send
+    size_t todo = xbuffer.size() - ( round % 5 == 0 ? 0 : xbuffer.size() / 3 );
+    for ( int i = 0; i < nseg && todo; ++i )
+    {
+      size_t len = std::min( todo, seglen[i] );
+      received.insert( received.end(), seg[i], seg[i] + len );
+      xbuffer.consume( len );
+      todo -= len;
+    }
+  }
+  INFO_PRINT << "xmit buffer: ";
+  if ( received.size() + xbuffer.size() == sent.size() &&
+       std::equal( received.begin(), received.end(), sent.begin() ) )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void latency_histogram_test()
+{
+  Network::IOStats stats;
+  auto& histogram = stats.inbound.queue_latency;
+  histogram.add( 0 );
+  histogram.add( 1 );
+  histogram.add( 1023 );
+  histogram.add( 1024 );
+  histogram.add( 60ull * 1000 * 1000 );  // one minute ends up in the open bucket
+  const size_t last = Network::IOStats::LatencyHistogram::BUCKETS - 1;
+  INFO_PRINT << "latency histogram: ";
+  if ( histogram.counts[0] == 1 && histogram.counts[1] == 1 && histogram.counts[10] == 1 &&
+       histogram.counts[11] == 1 && histogram.counts[last] == 1 )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void packet_timings_test()
+{
+  std::unique_ptr<Network::PacketTimings> timings( new Network::PacketTimings );
+  auto& handler = timings->handler[Core::PKTIN_02_ID];
+  for ( int i = 0; i < 98; ++i )
+    handler.add( 10 );
+  handler.add( 300 );
+  handler.add( 5000 );
+  INFO_PRINT << "packet timings: ";
+  bool ok = handler.count() == 100 && handler.total_us == 98 * 10 + 300 + 5000 &&
+            handler.percentile( 50 ) == 16 && handler.percentile( 99 ) == 512 &&
+            handler.percentile( 100 ) == 8192 && timings->build[Core::PKTIN_02_ID].count() == 0;
+  timings->reset();
+  ok = ok && handler.count() == 0 && handler.total_us == 0 && handler.percentile( 50 ) == 0;
+  if ( ok )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+void packet_pool_test()
+{
+  using namespace Network;
+  PacketsSingleton pool;
+  // readded packets are reused by the same thread
+  PacketInterface* first = pool.getPacket( Core::PKTOUT_77_ID );
+  pool.ReAddPacket( first );
+  PacketInterface* second = pool.getPacket( Core::PKTOUT_77_ID );
+  const PacketPoolStats& stats = pool.getStats( Core::PKTOUT_77_ID );
+  bool ok = first == second && stats.requests == 2 && stats.local_hits == 1 && stats.misses == 1 &&
+            stats.outstanding == 1 && stats.peak_outstanding == 1;
+  pool.ReAddPacket( second );
+
+  // sub packets are only handed out for their own sub id
+  PacketInterface* sub4 = pool.getPacket( PktOut_BF_Sub4::ID, PktOut_BF_Sub4::SUB );
+  pool.ReAddPacket( sub4 );
+  PacketInterface* sub8 = pool.getPacket( PktOut_BF_Sub8::ID, PktOut_BF_Sub8::SUB );
+  ok = ok && sub8 != sub4 && sub8->getSubID() == PktOut_BF_Sub8::SUB;
+  pool.ReAddPacket( sub8 );
+
+  // too many cached packets end up in the shared queue
+  std::vector<PacketInterface*> pkts;
+  for ( int i = 0; i < 40; ++i )
+    pkts.push_back( pool.getPacket( Core::PKTOUT_1A_ID ) );
+  for ( auto pkt : pkts )
+    pool.ReAddPacket( pkt );
+  // the thread keeps at most 16 packets
+  ok = ok && pool.getPackets()->at( Core::PKTOUT_1A_ID )->Count() >= 40 - 16 &&
+       pool.getStats( Core::PKTOUT_1A_ID ).peak_outstanding == 40;
+
+  // cached packets count for the memory usage
+  size_t size = pool.estimateSize();
+  PacketInterface* cached = pool.getPacket( Core::PKTOUT_77_ID );
+  ok = ok && pool.estimateSize() < size;
+  pool.ReAddPacket( cached );
+  ok = ok && pool.estimateSize() == size;
+
+  INFO_PRINT << "packet pool: ";
+  if ( ok )
+  {
+    INFO_PRINT << "Ok!\n";
+    inc_successes();
+  }
+  else
+  {
+    INFO_PRINT << "Failure!\n";
+    inc_failures();
+  }
+}
+
+#ifdef ENABLE_BENCHMARK
+static void BM_huffman_bitwise( benchmark::State& state )
+{
+  auto packets = sample_packets();
+  const auto& data = packets[state.range( 0 )];
+  std::vector<unsigned char> out( data.size() * 2 + 2 );
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize( huffman_compress_bitwise( data.data(), data.size(), out.data() ) );
+  }
+  state.SetBytesProcessed( state.iterations() * data.size() );
+}
+BENCHMARK( BM_huffman_bitwise )->DenseRange( 0, 3 );
+
+static void BM_huffman_table( benchmark::State& state )
+{
+  auto packets = sample_packets();
+  const auto& data = packets[state.range( 0 )];
+  std::vector<unsigned char> out( data.size() * 2 + 2 );
+  while ( state.KeepRunning() )
+  {
+    benchmark::DoNotOptimize(
+        Core::huffman_compress( data.data(), data.size(), out.data(), out.size() ) );
+  }
+  state.SetBytesProcessed( state.iterations() * data.size() );
+}
+BENCHMARK( BM_huffman_table )->DenseRange( 0, 3 );
+#endif
+}  // namespace Testing
+}  // namespace Pol
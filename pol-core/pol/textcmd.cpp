@@ -23,6 +23,7 @@
 
 #include "../bscript/berror.h"
 #include "../bscript/impstr.h"
+#include "../bscript/scriptsampler.h"
 #include "../clib/cfgelem.h"
 #include "../clib/cfgfile.h"
 #include "../clib/clib.h"
@@ -438,6 +439,22 @@ void textcmd_log_profile_clear( Network::Client* client )
   send_sysmessage( client, "Script profile written to logfile and cleared" );
 }
 
+void textcmd_start_script_sampling( Network::Client* client )
+{
+  start_script_sampling( 1000 );
+  send_sysmessage( client, "Script sampling started" );
+}
+
+void textcmd_stop_script_sampling( Network::Client* client )
+{
+  if ( !Bscript::script_sampler.running() )
+  {
+    send_sysmessage( client, "Script sampling is not running" );
+    return;
+  }
+  send_sysmessage( client, "Script samples written to " + stop_script_sampling() );
+}
+
 void textcmd_heapcheck( Network::Client* /*client*/ )
 {
   PrintAllocationData();
@@ -642,7 +659,9 @@ bool process_command( Network::Client* client, const std::string& text,
     register_command( "resendchars", &textcmd_resendchars );
     register_command( "shutdown", &textcmd_shutdown );
     register_command( "startlog", &textcmd_startlog );
+    register_command( "start_script_sampling", &textcmd_start_script_sampling );
     register_command( "stoplog", &textcmd_stoplog );
+    register_command( "stop_script_sampling", &textcmd_stop_script_sampling );
     register_command( "threads", &textcmd_threads );
   }
 
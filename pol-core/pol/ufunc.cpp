@@ -1492,18 +1492,24 @@ void send_death_message( Character* chr_died, Item* corpse )
 
 void transmit_to_inrange( const UObject* center, const void* msg, unsigned msglen )
 {
+  Network::PreparedPacketRef packet;
   WorldIterator<OnlinePlayerFilter>::InVisualRange( center, [&]( Character* zonechr ) {
-    Core::networkManager.clientTransmit->AddToQueue( zonechr->client, msg, msglen );
+    if ( !packet )
+      packet = std::make_shared<const Network::PreparedPacket>( msg, msglen );
+    Core::networkManager.clientTransmit->AddToQueue( zonechr->client, packet );
   } );
 }
 
 void transmit_to_others_inrange( Character* center, const void* msg, unsigned msglen )
 {
+  Network::PreparedPacketRef packet;
   WorldIterator<OnlinePlayerFilter>::InVisualRange( center, [&]( Character* zonechr ) {
     Client* client = zonechr->client;
     if ( zonechr == center )
       return;
-    Core::networkManager.clientTransmit->AddToQueue( client, msg, msglen );
+    if ( !packet )
+      packet = std::make_shared<const Network::PreparedPacket>( msg, msglen );
+    Core::networkManager.clientTransmit->AddToQueue( client, packet );
   } );
 }
 
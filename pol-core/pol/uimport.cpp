@@ -1237,7 +1237,7 @@ int write_data( unsigned int& dirty_writes, unsigned int& clean_writes, long lon
   objStorageManager.incremental_save_count = 0;
   timer.stop();
   objStorageManager.objecthash.ClearDeleted();
-  // optimize_zones(); // shrink zone vectors TODO this takes way to much time!
+  optimize_zones();  // shrink zone vectors
 
   // cout << "Clean: " << UObject::clean_writes << " Dirty: " <<
   // UObject::dirty_writes << endl;
@@ -41,6 +41,11 @@ namespace Pol
 {
 namespace Core
 {
+#if defined( __linux__ ) && defined( __x86_64__ ) && !REFPTR_DEBUG
+// every item and mobile pays for a larger UObject, e.g. zone_slot_ fits in the padding after flags_
+static_assert( sizeof( UObject ) == 128, "size missmatch" );
+#endif
+
 std::set<UObject*> unreaped_orphan_instances;
 std::ofstream orphans_txt( "orphans.txt", std::ios::out | std::ios::trunc );
 
@@ -82,6 +87,7 @@ UObject::UObject( u32 objtype, UOBJ_CLASS i_uobj_class )
       _rev( 0 ),
       name_( "" ),
       flags_(),
+      zone_slot_( 0 ),
       proplist_( CPropProfiler::class_to_type( i_uobj_class ) )
 {
   graphic = Items::getgraphic( objtype );
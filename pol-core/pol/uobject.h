@@ -40,6 +40,7 @@ namespace Bscript
 {
 class BObjectImp;
 class Executor;
+struct InlineCache;
 }  // namespace Bscript
 namespace Clib
 {
@@ -66,6 +67,8 @@ namespace Core
 class UContainer;
 class WornItemsContainer;
 class ExportScript;
+template <class T>
+class ZoneObjects;
 class UOExecutor;
 
 #pragma pack( push, 1 )
@@ -192,6 +195,12 @@ public:
   virtual Bscript::BObjectImp* make_ref() = 0;
   virtual Bscript::BObjectImp* get_script_member( const char* membername ) const;
   virtual Bscript::BObjectImp* get_script_member_id( const int id ) const;  /// id test
+  // get_script_member_id of a single call site, cache remembers for the class of this object
+  // which member switch answers the id
+  Bscript::BObjectImp* get_script_member_id_cached( const int id,
+                                                    Bscript::InlineCache& cache ) const;
+  // false if a class answers members of its base classes itself
+  virtual bool script_members_cacheable() const { return true; }
 
   virtual Bscript::BObjectImp* set_script_member( const char* membername,
                                                   const std::string& value );
@@ -244,6 +253,8 @@ protected:
   friend class ref_ptr<Items::UWeapon>;
   friend class ref_ptr<Items::UArmor>;
   friend class ref_ptr<WornItemsContainer>;
+  template <class T>
+  friend class ZoneObjects;
 
   // DATA:
 public:
@@ -301,6 +312,7 @@ protected:
   mutable AttributeFlags<OBJ_FLAGS> flags_;
 
 private:
+  u32 zone_slot_;  // index in the object list of its world zone, maintained by ZoneObjects
   PropertyList proplist_;
 
 private:  // not implemented:
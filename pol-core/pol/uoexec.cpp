@@ -21,6 +21,7 @@
 #include "mobile/attribute.h"
 #include "mobile/charactr.h"
 #include "module/osmod.h"
+#include "module/uomod.h"
 #include "multi/multi.h"
 #include "network/client.h"
 #include "party.h"
@@ -61,6 +62,14 @@ UOExecutor::~UOExecutor()
 {
   // note, the os_module isn't deleted here because
   // the Executor deletes its ExecutorModules.
+  log_profile();
+
+  pParent = nullptr;
+  pChild = nullptr;
+}
+
+void UOExecutor::log_profile() const
+{
   if ( ( instr_cycles >= 500 ) && settingsManager.watch.profile_scripts )
   {
     int elapsed = static_cast<int>(
@@ -68,11 +77,41 @@ UOExecutor::~UOExecutor()
     POLLOG_ERROR.Format( "Script {}: {} instr cycles, {} sleep cycles, {} seconds\n" )
         << scriptname() << instr_cycles << sleep_cycles << elapsed;
   }
+}
 
+void UOExecutor::reset()
+{
+  log_profile();
+  instr_cycles = 0;
+  removeModule( findModule( "uo" ) );
+  removeModule( os_module );
+  os_module = nullptr;
+  base::reset();
+  // script objects of the finished script must not see the next one
+  weakptr.renew( this );
   pParent = nullptr;
   pChild = nullptr;
 }
 
+void UOExecutor::restart()
+{
+  os_module = new Module::OSExecutorModule( *this );
+  addModule( os_module );
+  addModule( new Module::UOExecutorModule( *this ) );
+
+  instr_cycles = 0;
+  sleep_cycles = 0;
+  start_time = poltime();
+  warn_runaway_on_cycle = Plib::systemstate.config.runaway_script_threshold;
+  runaway_cycles = 0;
+  eventmask = 0;
+  area_size = 0;
+  speech_size = 1;
+  can_access_offline_mobiles_ = false;
+  auxsvc_assume_string = false;
+  survive_attached_disconnect = false;
+}
+
 bool UOExecutor::suspend()
 {
   // Run to completion scripts can't be suspended
@@ -72,6 +72,12 @@ public:
   virtual ~UOExecutor();
   virtual size_t sizeEstimate() const override;
 
+  // Drops the finished script together with the modules holding per script state (os with the
+  // pid and events, uo). The other modules stay attached, see ScriptScheduler::release_executor().
+  void reset();
+  // attaches new os and uo modules to a reset executor and starts the counters from scratch
+  void restart();
+
   bool suspend();
   bool revive();
 
@@ -145,6 +151,9 @@ public:
   bool getVitalParam( unsigned param, const Vital*& vital );
   bool getGuildParam( unsigned param, Core::Guild*& guild, Bscript::BError*& err );
   bool getPartyParam( unsigned param, Core::Party*& party, Bscript::BError*& err );
+
+private:
+  void log_profile() const;
 };
 
 inline bool UOExecutor::listens_to( unsigned int eventflag ) const
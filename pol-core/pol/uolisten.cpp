@@ -20,6 +20,8 @@
 #include "core.h"
 #include "globals/network.h"
 #include "network/client.h"
+#include "network/clientreactor.h"
+#include "network/inboundqueue.h"
 #include "network/clienttransmit.h"
 #include "network/cliface.h"
 #include "polsem.h"
@@ -47,6 +49,11 @@ void UoClientThread::run()
     if ( !create() )
       return;
   }
+  if ( networkManager.clientReactor )
+  {
+    networkManager.clientReactor->add( client );
+    return;
+  }
   client->thread_pid = threadhelp::thread_pid();
   client_io_thread( client );
 }
@@ -147,7 +154,10 @@ void uo_client_listener_thread( void* arg )
 
         if ( client->isConnected() && client->chr )
         {
-          Clib::SocketClientThread::start_thread( itr->release() );
+          if ( networkManager.clientReactor )
+            networkManager.clientReactor->add( client );
+          else
+            Clib::SocketClientThread::start_thread( itr->release() );
           itr = ls->login_clients.erase( itr );
         }
         else if ( ( ( *itr )->login_time +
@@ -175,6 +185,24 @@ void uo_client_listener_thread( void* arg )
 
 void start_uo_client_listeners( void )
 {
+  if ( Plib::systemstate.config.transmit_threads > 1 )
+    INFO_PRINT << "Transmitting client packets with " << Plib::systemstate.config.transmit_threads
+               << " threads\n";
+  networkManager.clientTransmit->Init( Plib::systemstate.config.transmit_threads );
+  if ( Plib::systemstate.config.queue_inbound_messages )
+  {
+    INFO_PRINT << "Handling client messages in the inbound queue thread\n";
+    networkManager.inboundQueue.reset( new Network::InboundQueue() );
+    threadhelp::start_thread( Network::InboundQueueThread, "InboundQueue" );
+  }
+  if ( Plib::systemstate.config.network_reactor_threads )
+  {
+    INFO_PRINT << "Handling client i/o with " << Plib::systemstate.config.network_reactor_threads
+               << " reactor threads\n";
+    networkManager.clientReactor.reset(
+        new Network::ClientReactor( Plib::systemstate.config.network_reactor_threads ) );
+    networkManager.clientReactor->start();
+  }
   for ( unsigned i = 0; i < networkManager.uoclient_listeners.size(); ++i )
   {
     UoClientListener* ls = &networkManager.uoclient_listeners[i];
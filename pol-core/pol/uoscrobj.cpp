@@ -52,11 +52,14 @@
 #include "uoscrobj.h"
 
 #include <string>
+#include <typeinfo>
 
 #include "../bscript/berror.h"
 #include "../bscript/dict.h"
+#include "../bscript/escriptv.h"
 #include "../bscript/execmodl.h"
 #include "../bscript/executor.h"
+#include "../bscript/executortype.h"
 #include "../bscript/impstr.h"
 #include "../bscript/objmembers.h"
 #include "../bscript/objmethods.h"
@@ -149,6 +152,14 @@ BObjectRef ECharacterRefObjImp::get_member_id( const int id )
   return BObjectRef( UninitObject::create() );
 }
 
+BObjectRef ECharacterRefObjImp::get_member_id_cached( const int id, InlineCache& cache )
+{
+  BObjectImp* result = obj_->get_script_member_id_cached( id, cache );
+  if ( result != nullptr )
+    return BObjectRef( result );
+  return BObjectRef( UninitObject::create() );
+}
+
 BObjectRef ECharacterRefObjImp::get_member( const char* membername )
 {
   ObjMember* objmember = getKnownObjMember( membername );
@@ -311,6 +322,14 @@ BObjectRef EItemRefObjImp::get_member_id( const int id )
   return BObjectRef( UninitObject::create() );
 }
 
+BObjectRef EItemRefObjImp::get_member_id_cached( const int id, InlineCache& cache )
+{
+  BObjectImp* result = obj_->get_script_member_id_cached( id, cache );
+  if ( result != nullptr )
+    return BObjectRef( result );
+  return BObjectRef( UninitObject::create() );
+}
+
 BObjectRef EItemRefObjImp::get_member( const char* membername )
 {
   ObjMember* objmember = getKnownObjMember( membername );
@@ -736,6 +755,77 @@ BObjectImp* UObject::get_script_member_id( const int id ) const
   }
 }
 
+namespace
+{
+// what a member access call site resolved to, see UObject::get_script_member_id_cached
+enum MemberResolution
+{
+  RESOLVED_VIRTUAL = 0,
+  RESOLVED_UOBJECT,
+  RESOLVED_ITEM,
+  RESOLVED_CHARACTER
+};
+}  // namespace
+
+BObjectImp* UObject::get_script_member_id_cached( const int id, InlineCache& cache ) const
+{
+  // the member switches of UObject, Item and Character answer an id independent of the object
+  // state, so once a call site knows which of them holds the member for a given class the
+  // switches in front of it and the virtual chain behind it can be skipped
+  const void* receiver = &typeid( *this );
+  if ( cache.receiver == receiver )
+  {
+    ++escript_inline_cache_hits;
+    BObjectImp* imp = nullptr;
+    switch ( cache.resolution )
+    {
+    case RESOLVED_UOBJECT:
+      return UObject::get_script_member_id( id );
+    case RESOLVED_ITEM:
+      if ( orphan() )
+        return new UninitObject;
+      imp = static_cast<const Items::Item*>( this )->get_item_script_member_id( id );
+      break;
+    case RESOLVED_CHARACTER:
+      if ( orphan() )
+        return new UninitObject;
+      imp = static_cast<const Mobile::Character*>( this )->get_character_script_member_id( id );
+      break;
+    default:
+      break;
+    }
+    if ( imp != nullptr )
+      return imp;
+    return get_script_member_id( id );
+  }
+
+  ++escript_inline_cache_misses;
+  if ( orphan() || !script_members_cacheable() )
+    return get_script_member_id( id );
+
+  cache.receiver = receiver;
+  BObjectImp* imp = UObject::get_script_member_id( id );
+  if ( imp != nullptr )
+  {
+    cache.resolution = RESOLVED_UOBJECT;
+    return imp;
+  }
+  if ( isitem() )
+  {
+    imp = static_cast<const Items::Item*>( this )->get_item_script_member_id( id );
+    cache.resolution = RESOLVED_ITEM;
+  }
+  else if ( ismobile() )
+  {
+    imp = static_cast<const Mobile::Character*>( this )->get_character_script_member_id( id );
+    cache.resolution = RESOLVED_CHARACTER;
+  }
+  if ( imp != nullptr )
+    return imp;
+  cache.resolution = RESOLVED_VIRTUAL;
+  return get_script_member_id( id );
+}
+
 BObjectImp* UObject::get_script_member( const char* membername ) const
 {
   ObjMember* objmember = getKnownObjMember( membername );
@@ -826,7 +916,11 @@ BObjectImp* Item::get_script_member_id( const int id ) const
   BObjectImp* imp = base::get_script_member_id( id );
   if ( imp != nullptr )
     return imp;
+  return get_item_script_member_id( id );
+}
 
+BObjectImp* Item::get_item_script_member_id( const int id ) const
+{
   switch ( id )
   {
   case MBR_AMOUNT:
@@ -1913,8 +2007,11 @@ BObjectImp* Character::get_script_member_id( const int id ) const
   BObjectImp* imp = base::get_script_member_id( id );
   if ( imp != nullptr )
     return imp;
+  return get_character_script_member_id( id );
+}
 
-
+BObjectImp* Character::get_character_script_member_id( const int id ) const
+{
   auto EnforceCaps = []( s16 baseValue, const s16 capValue ) -> s16 {
     const bool ignore_caps = Core::settingsManager.ssopt.core_ignores_defence_caps;
 
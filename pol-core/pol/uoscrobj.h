@@ -87,6 +87,8 @@ public:
                                                   bool forcebuiltin = false ) override;
   virtual Bscript::BObjectRef get_member( const char* membername ) override;
   virtual Bscript::BObjectRef get_member_id( const int id ) override;  /// id test
+  virtual Bscript::BObjectRef get_member_id_cached( const int id,
+                                                    Bscript::InlineCache& cache ) override;
   virtual Bscript::BObjectRef set_member( const char* membername, Bscript::BObjectImp* value,
                                           bool copy ) override;
   virtual Bscript::BObjectRef set_member_id( const int id, Bscript::BObjectImp* value,
@@ -145,6 +147,8 @@ public:
                                                   bool forcebuiltin = false ) override;
   virtual Bscript::BObjectRef get_member( const char* membername ) override;
   virtual Bscript::BObjectRef get_member_id( const int id ) override;  // id test
+  virtual Bscript::BObjectRef get_member_id_cached( const int id,
+                                                    Bscript::InlineCache& cache ) override;
   virtual Bscript::BObjectRef set_member( const char* membername, Bscript::BObjectImp* value,
                                           bool copy ) override;
   virtual Bscript::BObjectRef set_member_id( const int id, Bscript::BObjectImp* value,
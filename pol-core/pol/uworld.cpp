@@ -28,14 +28,31 @@ namespace Pol
 {
 namespace Core
 {
+namespace
+{
+// for the unordered zone lists, false if obj isn't in the list
+template <class T>
+bool remove_unordered( std::vector<T*>& objects, const T* obj )
+{
+  auto itr = std::find( objects.begin(), objects.end(), obj );
+  if ( itr == objects.end() )
+    return false;
+  *itr = objects.back();
+  objects.pop_back();
+  return true;
+}
+}  // namespace
+
 void add_item_to_world( Items::Item* item )
 {
   Zone& zone = getzone( item->x, item->y, item->realm );
 
-  passert( std::find( zone.items.begin(), zone.items.end(), item ) == zone.items.end() );
+  passert( !zone.items.contains( item ) );
 
   item->realm->add_toplevel_item( *item );
-  zone.items.push_back( item );
+  zone.items.add( item );
+  if ( item->process() != nullptr )
+    zone.controlled_items.push_back( item );
 }
 
 void remove_item_from_world( Items::Item* item )
@@ -51,37 +68,36 @@ void remove_item_from_world( Items::Item* item )
 
   Zone& zone = getzone( item->x, item->y, item->realm );
 
-  ZoneItems::iterator itr = std::find( zone.items.begin(), zone.items.end(), item );
-  if ( itr == zone.items.end() )
+  bool removed = zone.items.remove( item );
+  if ( !removed )
   {
     POLLOG_ERROR.Format(
         "remove_item_from_world: item 0x{:X} at {},{} does not exist in world zone ( Old Serial: "
         "0x{:X} )\n" )
         << item->serial << item->x << item->y << ( cfBEu32( item->serial_ext ) );
 
-    passert( itr != zone.items.end() );
+    passert( removed );
   }
 
   item->realm->remove_toplevel_item( *item );
-  zone.items.erase( itr );
+  remove_unordered( zone.controlled_items, item );
 }
 
 void add_multi_to_world( Multi::UMulti* multi )
 {
   Zone& zone = getzone( multi->x, multi->y, multi->realm );
-  zone.multis.push_back( multi );
+  zone.multis.add( multi );
   multi->realm->add_multi( *multi );
 }
 
 void remove_multi_from_world( Multi::UMulti* multi )
 {
   Zone& zone = getzone( multi->x, multi->y, multi->realm );
-  ZoneMultis::iterator itr = std::find( zone.multis.begin(), zone.multis.end(), multi );
+  bool removed = zone.multis.remove( multi );
 
-  passert( itr != zone.multis.end() );
+  passert( removed );
 
   multi->realm->remove_multi( *multi );
-  zone.multis.erase( itr );
 }
 
 void move_multi_in_world( unsigned short oldx, unsigned short oldy, unsigned short newx,
@@ -92,12 +108,13 @@ void move_multi_in_world( unsigned short oldx, unsigned short oldy, unsigned sho
 
   if ( &oldzone != &newzone )
   {
-    ZoneMultis::iterator itr = std::find( oldzone.multis.begin(), oldzone.multis.end(), multi );
-    passert( itr != oldzone.multis.end() );
+    bool removed = oldzone.multis.remove( multi );
+    passert( removed );
 
-    oldzone.multis.erase( itr );
-    newzone.multis.push_back( multi );
+    newzone.multis.add( multi );
   }
+  // called before multi->x/y get set
+  newzone.multis.moved( multi, newx, newy );
 
   if ( multi->realm != oldrealm )
   {
@@ -130,14 +147,18 @@ void SetCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
   Zone& zone = getzone( chr->x, chr->y, chr->realm );
 
   auto set_pos = [&]( ZoneCharacters& set ) {
-    passert( std::find( set.begin(), set.end(), chr ) == set.end() );
-    set.push_back( chr );
+    passert( !set.contains( chr ) );
+    set.add( chr );
   };
 
   if ( chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
     set_pos( zone.npcs );
   else
+  {
     set_pos( zone.characters );
+    if ( chr->connected() )
+      zone.online_players.push_back( chr );
+  }
 
   chr->realm->add_mobile( *chr, reason );
 }
@@ -151,19 +172,21 @@ void ClrCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
   Zone& zone = getzone( chr->x, chr->y, chr->realm );
 
   auto clear_pos = [&]( ZoneCharacters& set ) {
-    auto itr = std::find( set.begin(), set.end(), chr );
-    if ( itr == set.end() )
+    bool removed = set.remove( chr );
+    if ( !removed )
     {
       find_missing_char_in_zone(
           chr, reason );  // Uh-oh, char was not in the expected zone. Find it and report.
-      passert( itr != set.end() );
+      passert( removed );
     }
     chr->realm->remove_mobile( *chr, reason );
-    set.erase( itr );
   };
 
   if ( !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
+  {
     clear_pos( zone.characters );
+    remove_unordered( zone.online_players, chr );
+  }
   else
     clear_pos( zone.npcs );
 }
@@ -185,22 +208,30 @@ void MoveCharacterWorldPosition( unsigned short oldx, unsigned short oldy, unsig
     if ( &oldzone != &newzone )
     {
       auto move_pos = [&]( ZoneCharacters& oldset, ZoneCharacters& newset ) {
-        auto oldset_itr = std::find( oldset.begin(), oldset.end(), chr );
+        bool removed = oldset.remove( chr );
 
         // ensure it's found in the old realm
-        passert( oldset_itr != oldset.end() );
+        passert( removed );
         // and that it's not yet in the new realm
-        passert( std::find( newset.begin(), newset.end(), chr ) == newset.end() );
+        passert( !newset.contains( chr ) );
 
-        oldset.erase( oldset_itr );
-        newset.push_back( chr );
+        newset.add( chr );
       };
 
       if ( !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
+      {
         move_pos( oldzone.characters, newzone.characters );
+        if ( remove_unordered( oldzone.online_players, chr ) )
+          newzone.online_players.push_back( chr );
+      }
       else
         move_pos( oldzone.npcs, newzone.npcs );
     }
+    // called before chr->x/y get set
+    if ( !chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) )
+      newzone.characters.moved( chr, newx, newy );
+    else
+      newzone.npcs.moved( chr, newx, newy );
   }
 
   // Regardless of online or not, tell the realms that we've left
@@ -211,6 +242,40 @@ void MoveCharacterWorldPosition( unsigned short oldx, unsigned short oldy, unsig
   }
 }
 
+void UpdateCharacterOnlineZone( Mobile::Character* chr )
+{
+  if ( chr->isa( Core::UOBJ_CLASS::CLASS_NPC ) || chr->realm == nullptr )
+    return;
+  Zone& zone = getzone( chr->x, chr->y, chr->realm );
+  // not yet or no longer in the world
+  if ( !zone.characters.contains( chr ) )
+    return;
+  bool online =
+      std::find( zone.online_players.begin(), zone.online_players.end(), chr ) !=
+      zone.online_players.end();
+  if ( chr->connected() && !online )
+    zone.online_players.push_back( chr );
+  else if ( !chr->connected() && online )
+    remove_unordered( zone.online_players, chr );
+}
+
+void UpdateItemControlZone( Items::Item* item )
+{
+  if ( item->container != nullptr || item->realm == nullptr )
+    return;
+  Zone& zone = getzone( item->x, item->y, item->realm );
+  // not yet or no longer in the world
+  if ( !zone.items.contains( item ) )
+    return;
+  bool listed = std::find( zone.controlled_items.begin(), zone.controlled_items.end(), item ) !=
+                zone.controlled_items.end();
+  bool controlled = item->process() != nullptr;
+  if ( controlled && !listed )
+    zone.controlled_items.push_back( item );
+  else if ( !controlled && listed )
+    remove_unordered( zone.controlled_items, item );
+}
+
 void MoveItemWorldPosition( unsigned short oldx, unsigned short oldy, Items::Item* item,
                             Realms::Realm* oldrealm )
 {
@@ -222,9 +287,9 @@ void MoveItemWorldPosition( unsigned short oldx, unsigned short oldy, Items::Ite
 
   if ( &oldzone != &newzone )
   {
-    ZoneItems::iterator itr = std::find( oldzone.items.begin(), oldzone.items.end(), item );
+    bool removed = oldzone.items.remove( item );
 
-    if ( itr == oldzone.items.end() )
+    if ( !removed )
     {
       POLLOG_ERROR.Format(
           "MoveItemWorldPosition: item 0x{:X} at old-x/y({},{} - {}) new-x/y({},{} - {}) does not "
@@ -232,13 +297,17 @@ void MoveItemWorldPosition( unsigned short oldx, unsigned short oldy, Items::Ite
           << item->serial << oldx << oldy << oldrealm->name() << item->x << item->y
           << item->realm->name();
 
-      passert( itr != oldzone.items.end() );
+      passert( removed );
     }
 
-    oldzone.items.erase( itr );
-
-    passert( std::find( newzone.items.begin(), newzone.items.end(), item ) == newzone.items.end() );
-    newzone.items.push_back( item );
+    passert( !newzone.items.contains( item ) );
+    newzone.items.add( item );
+    if ( remove_unordered( oldzone.controlled_items, item ) )
+      newzone.controlled_items.push_back( item );
+  }
+  else
+  {
+    newzone.items.moved( item, item->x, item->y );
   }
 
   if ( oldrealm != item->realm )
@@ -281,15 +350,9 @@ void find_missing_char_in_zone( Mobile::Character* chr, Realms::WorldChangeReaso
     {
       bool found = false;
       if ( is_npc )
-      {
-        auto _z = chr->realm->zone[zonex][zoney].npcs;
-        found = std::find( _z.begin(), _z.end(), chr ) != _z.end();
-      }
+        found = chr->realm->zone[zonex][zoney].npcs.contains( chr );
       else
-      {
-        auto _z = chr->realm->zone[zonex][zoney].characters;
-        found = std::find( _z.begin(), _z.end(), chr ) != _z.end();
-      }
+        found = chr->realm->zone[zonex][zoney].characters.contains( chr );
       if ( found )
         POLLOG_ERROR.Format( "ClrCharacterWorldPosition: Found mob in zone ({},{})\n" )
             << zonex << zoney;
@@ -304,8 +367,9 @@ bool check_single_zone_item_integrity( int x, int y, Realms::Realm* realm )
   {
     ZoneItems& witem = realm->zone[x][y].items;
 
-    for ( const auto& item : witem )
+    for ( ZoneItems::size_type idx = 0; idx < witem.size(); ++idx )
     {
+      const Items::Item* item = witem[idx];
       unsigned short wx, wy;
       zone_convert( item->x, item->y, &wx, &wy, realm );
       if ( wx != x || wy != y )
@@ -314,6 +378,22 @@ bool check_single_zone_item_integrity( int x, int y, Realms::Realm* realm )
             << item->serial << x << y << item->x << item->y << wx << wy;
         return false;
       }
+      const auto& coords = witem.coords( idx );
+      if ( coords.x != item->x || coords.y != item->y )
+      {
+        POLLOG_ERROR.Format( "Item 0x{:X} at ({},{}) is known to its zone at ({},{})\n" )
+            << item->serial << item->x << item->y << coords.x << coords.y;
+        return false;
+      }
+    }
+    for ( const auto& item : realm->zone[x][y].controlled_items )
+    {
+      if ( !witem.contains( item ) || item->process() == nullptr )
+      {
+        POLLOG_ERROR.Format( "Item 0x{:X} is a controlled item of zone ({},{}) by mistake\n" )
+            << item->serial << x << y;
+        return false;
+      }
     }
   }
   catch ( ... )
@@ -384,7 +464,8 @@ void check_character_integrity()
   }
 }
 
-// reallocates all vectors to fit the current size
+// reallocates the vectors which use less than half of their memory
+// only those get copied, so it's cheap enough to run after every save
 void optimize_zones()
 {
   for ( auto& realm : gamestate.Realms )
@@ -396,10 +477,10 @@ void optimize_zones()
     {
       for ( unsigned y = 0; y < gridheight; ++y )
       {
-        realm->zone[x][y].characters.shrink_to_fit();
-        realm->zone[x][y].npcs.shrink_to_fit();
-        realm->zone[x][y].items.shrink_to_fit();
-        realm->zone[x][y].multis.shrink_to_fit();
+        realm->zone[x][y].characters.shrink_if_sparse();
+        realm->zone[x][y].npcs.shrink_if_sparse();
+        realm->zone[x][y].items.shrink_if_sparse();
+        realm->zone[x][y].multis.shrink_if_sparse();
       }
     }
   }
@@ -23,6 +23,8 @@
 #include "mobile/charactr.h"
 #endif
 #include <algorithm>
+#include <cstdlib>
+#include <utility>
 #include <vector>
 
 #include "../clib/passert.h"
@@ -50,20 +52,133 @@ void ClrCharacterWorldPosition( Mobile::Character* chr, Realms::WorldChangeReaso
 void MoveCharacterWorldPosition( unsigned short oldx, unsigned short oldy, unsigned short newx,
                                  unsigned short newy, Mobile::Character* chr,
                                  Realms::Realm* oldrealm );
+// adds chr to or removes it from the online players of its zone, call when chr->connected() changed
+void UpdateCharacterOnlineZone( Mobile::Character* chr );
 
 void SetItemWorldPosition( Items::Item* item );
 void ClrItemWorldPosition( Items::Item* item );
 void MoveItemWorldPosition( unsigned short oldx, unsigned short oldy, Items::Item* item,
                             Realms::Realm* oldrealm );
+// adds item to or removes it from the controlled items of its zone, call when item->process() changed
+void UpdateItemControlZone( Items::Item* item );
 
 int get_toplevel_item_count();
 int get_mobile_count();
 
-void optimize_zones();
+void optimize_zones();  // frees unused memory of the zones
+
+// The objects of one kind in a zone. Their coordinates are packed into a second vector, so range
+// queries sort out the objects outside of the area without touching them.
+// The coordinates are updated by add_item_to_world(), MoveItemWorldPosition() etc., every move of
+// an object inside of the world has to go through these functions.
+// Every object knows its index in the list, so finding and removing it takes constant time.
+// The order of the objects is unspecified: removing one moves the last object into its place.
+// Loops over the indices which remove the current object have to visit the index again.
+template <class T>
+class ZoneObjects
+{
+public:
+  typedef typename std::vector<T*>::size_type size_type;
+  typedef typename std::vector<T*>::const_iterator const_iterator;
+  struct Coords
+  {
+    u16 x;
+    u16 y;
+  };
+
+  const_iterator begin() const { return objects_.begin(); }
+  const_iterator end() const { return objects_.end(); }
+  size_type size() const { return objects_.size(); }
+  bool empty() const { return objects_.empty(); }
+  T* operator[]( size_type idx ) const { return objects_[idx]; }
+  // position of the object at idx as the zone knows it
+  const Coords& coords( size_type idx ) const { return coords_[idx]; }
+  bool contains( const T* obj ) const
+  {
+    return obj->zone_slot_ < objects_.size() && objects_[obj->zone_slot_] == obj;
+  }
 
-typedef std::vector<Mobile::Character*> ZoneCharacters;
-typedef std::vector<Multi::UMulti*> ZoneMultis;
-typedef std::vector<Items::Item*> ZoneItems;
+  void add( T* obj )
+  {
+    obj->zone_slot_ = static_cast<u32>( objects_.size() );
+    objects_.push_back( obj );
+    coords_.push_back( Coords{obj->x, obj->y} );
+  }
+  // false if obj isn't in the zone
+  bool remove( const T* obj )
+  {
+    if ( !contains( obj ) )
+      return false;
+    const u32 slot = obj->zone_slot_;
+    T* last = objects_.back();
+    objects_[slot] = last;
+    coords_[slot] = coords_.back();
+    last->zone_slot_ = slot;
+    objects_.pop_back();
+    coords_.pop_back();
+    return true;
+  }
+  // obj moved inside of the zone
+  void moved( const T* obj, u16 x, u16 y )
+  {
+    if ( contains( obj ) )
+      coords_[obj->zone_slot_] = Coords{x, y};
+  }
+  void clear()
+  {
+    objects_.clear();
+    coords_.clear();
+  }
+  void shrink_to_fit()
+  {
+    objects_.shrink_to_fit();
+    coords_.shrink_to_fit();
+  }
+  // shrink_to_fit() if at least half of the reserved memory is unused, true if it did
+  bool shrink_if_sparse()
+  {
+    const size_type unused = objects_.capacity() - objects_.size();
+    if ( unused < 16 || unused < objects_.size() )
+      return false;
+    shrink_to_fit();
+    return true;
+  }
+  size_t sizeEstimate() const
+  {
+    return sizeof( *this ) + objects_.capacity() * sizeof( T* ) +
+           coords_.capacity() * sizeof( Coords );
+  }
+
+  // calls f for every object inside of the box, only reads the packed coordinates of the others
+  template <typename F>
+  void for_each_in( int xL, int yL, int xH, int yH, F&& f ) const
+  {
+    if ( xH < xL || yH < yL )
+      return;
+    const unsigned width = static_cast<unsigned>( xH - xL );
+    const unsigned height = static_cast<unsigned>( yH - yL );
+    for ( size_type idx = 0; idx < coords_.size(); ++idx )
+    {
+      const Coords& c = coords_[idx];
+      if ( static_cast<unsigned>( c.x - xL ) <= width &&
+           static_cast<unsigned>( c.y - yL ) <= height )
+        f( objects_[idx] );
+    }
+  }
+
+private:
+  std::vector<T*> objects_;
+  std::vector<Coords> coords_;  // parallel to objects_
+};
+
+typedef ZoneObjects<Mobile::Character> ZoneCharacters;
+typedef ZoneObjects<Multi::UMulti> ZoneMultis;
+typedef ZoneObjects<Items::Item> ZoneItems;
+// the connected players out of ZoneCharacters, unordered
+typedef std::vector<Mobile::Character*> ZoneOnlinePlayers;
+// the items out of ZoneItems with a control script, the only ones which react to mobiles moving
+// around them, unordered
+typedef std::vector<Items::Item*> ZoneControlledItems;
 
 struct Zone
 {
@@ -71,6 +186,8 @@ struct Zone
   ZoneCharacters npcs;
   ZoneItems items;
   ZoneMultis multis;
+  ZoneOnlinePlayers online_players;
+  ZoneControlledItems controlled_items;
 };
 
 inline void zone_convert( unsigned short x, unsigned short y, unsigned short* wx,
@@ -128,20 +245,29 @@ struct WorldIterator
   static void InVisualRange( const UObject* obj, F&& f );
   template <typename F>
   static void InBox( u16 x1, u16 y1, u16 x2, u16 y2, const Realms::Realm* realm, F&& f );
+  // objects in range of x,y which weren't in range of oldx,oldy
+  // only the strips along the edges which came into range get visited
+  template <typename F>
+  static void NewlyInRange( u16 x, u16 y, u16 oldx, u16 oldy, const Realms::Realm* realm,
+                            unsigned range, F&& f );
 
 protected:
   template <typename F>
   static void _forEach( const CoordsArea& coords, const Realms::Realm* realm, F&& f );
+  template <typename F>
+  static void _forEachInStrip( int x1, int y1, int x2, int y2, const Realms::Realm* realm,
+                               F& f );
 };
 
 enum class FilterType
 {
-  Mobile,        // iterator over npcs and players
-  Player,        // iterator over player
-  OnlinePlayer,  // iterator over online player
-  NPC,           // iterator over npcs
-  Item,          // iterator over items
-  Multi          // iterator over multis
+  Mobile,          // iterator over npcs and players
+  Player,          // iterator over player
+  OnlinePlayer,    // iterator over online player
+  NPC,             // iterator over npcs
+  Item,            // iterator over items
+  ControlledItem,  // iterator over items with a control script
+  Multi            // iterator over multis
 };
 
 // Filter implementation struct,
@@ -162,6 +288,7 @@ typedef FilterImp<FilterType::Player> PlayerFilter;
 typedef FilterImp<FilterType::OnlinePlayer> OnlinePlayerFilter;
 typedef FilterImp<FilterType::NPC> NPCFilter;
 typedef FilterImp<FilterType::Item> ItemFilter;
+typedef FilterImp<FilterType::ControlledItem> ControlledItemFilter;
 typedef FilterImp<FilterType::Multi> MultiFilter;
 
 namespace
@@ -173,6 +300,8 @@ struct CoordsArea
   CoordsArea( u16 x, u16 y, const Realms::Realm* realm, unsigned range );    // create from range
   CoordsArea( u16 x1, u16 y1, u16 x2, u16 y2, const Realms::Realm* realm );  // create from box
   bool inRange( const UObject* obj ) const;
+  template <class T, typename F>
+  void forEachInRange( const ZoneObjects<T>& objects, F&& f ) const;
 
   // shifted coords
   u16 wxL;
@@ -221,6 +350,12 @@ inline bool CoordsArea::inRange( const UObject* obj ) const
   return ( obj->x >= _xL && obj->x <= _xH && obj->y >= _yL && obj->y <= _yH );
 }
 
+template <class T, typename F>
+inline void CoordsArea::forEachInRange( const ZoneObjects<T>& objects, F&& f ) const
+{
+  objects.for_each_in( _xL, _yL, _xH, _yH, std::forward<F>( f ) );
+}
+
 inline void CoordsArea::convert( int xL, int yL, int xH, int yH, const Realms::Realm* realm )
 {
   zone_convert_clip( xL, yL, realm, &wxL, &wyL );
@@ -258,6 +393,52 @@ void WorldIterator<Filter>::InBox( u16 x1, u16 y1, u16 x2, u16 y2, const Realms:
   _forEach( coords, realm, std::forward<F>( f ) );
 }
 
+template <class Filter>
+template <typename F>
+void WorldIterator<Filter>::NewlyInRange( u16 x, u16 y, u16 oldx, u16 oldy,
+                                          const Realms::Realm* realm, unsigned range, F&& f )
+{
+  if ( realm == nullptr )
+    return;
+  const int r = static_cast<int>( range );
+  const int dx = x - oldx;
+  const int dy = y - oldy;
+  if ( std::abs( dx ) > 2 * r || std::abs( dy ) > 2 * r )
+  {
+    // the ranges don't overlap
+    InRange( x, y, realm, range, std::forward<F>( f ) );
+    return;
+  }
+  // columns which came into range, full height
+  if ( dx > 0 )
+    _forEachInStrip( oldx + r + 1, y - r, x + r, y + r, realm, f );
+  else if ( dx < 0 )
+    _forEachInStrip( x - r, y - r, oldx - r - 1, y + r, realm, f );
+  // rows which came into range, without the columns above
+  const int xL = std::max( x, oldx ) - r;
+  const int xH = std::min( x, oldx ) + r;
+  if ( dy > 0 )
+    _forEachInStrip( xL, oldy + r + 1, xH, y + r, realm, f );
+  else if ( dy < 0 )
+    _forEachInStrip( xL, y - r, xH, oldy - r - 1, realm, f );
+}
+
+template <class Filter>
+template <typename F>
+void WorldIterator<Filter>::_forEachInStrip( int x1, int y1, int x2, int y2,
+                                             const Realms::Realm* realm, F& f )
+{
+  x1 = std::max( x1, 0 );
+  y1 = std::max( y1, 0 );
+  x2 = std::min( x2, static_cast<int>( realm->width() ) - 1 );
+  y2 = std::min( y2, static_cast<int>( realm->height() ) - 1 );
+  if ( x1 > x2 || y1 > y2 )
+    return;
+  CoordsArea coords( static_cast<u16>( x1 ), static_cast<u16>( y1 ), static_cast<u16>( x2 ),
+                     static_cast<u16>( y2 ), realm );
+  _forEach( coords, realm, f );
+}
+
 template <class Filter>
 template <typename F>
 void WorldIterator<Filter>::_forEach( const CoordsArea& coords, const Realms::Realm* realm, F&& f )
@@ -277,40 +458,26 @@ template <>
 template <typename F>
 void FilterImp<FilterType::Mobile>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
-  {
-    if ( coords.inRange( chr ) )
-      f( chr );
-  }
-  for ( auto& npc : zone.npcs )
-  {
-    if ( coords.inRange( npc ) )
-      f( npc );
-  }
+  coords.forEachInRange( zone.characters, f );
+  coords.forEachInRange( zone.npcs, f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Player>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
-  {
-    if ( coords.inRange( chr ) )
-      f( chr );
-  }
+  coords.forEachInRange( zone.characters, f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::OnlinePlayer>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& chr : zone.characters )
+  // only a few players, no need for packed coordinates
+  for ( auto& chr : zone.online_players )
   {
-    if ( chr->has_active_client() )
-    {
-      if ( coords.inRange( chr ) )
-        f( chr );
-    }
+    if ( coords.inRange( chr ) && chr->has_active_client() )
+      f( chr );
   }
 }
 
@@ -318,18 +485,22 @@ template <>
 template <typename F>
 void FilterImp<FilterType::NPC>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& npc : zone.npcs )
-  {
-    if ( coords.inRange( npc ) )
-      f( npc );
-  }
+  coords.forEachInRange( zone.npcs, f );
 }
 
 template <>
 template <typename F>
 void FilterImp<FilterType::Item>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& item : zone.items )
+  coords.forEachInRange( zone.items, f );
+}
+
+template <>
+template <typename F>
+void FilterImp<FilterType::ControlledItem>::call( Core::Zone& zone, const CoordsArea& coords,
+                                                  F&& f )
+{
+  for ( auto& item : zone.controlled_items )
   {
     if ( coords.inRange( item ) )
       f( item );
@@ -340,11 +511,7 @@ template <>
 template <typename F>
 void FilterImp<FilterType::Multi>::call( Core::Zone& zone, const CoordsArea& coords, F&& f )
 {
-  for ( auto& multi : zone.multis )
-  {
-    if ( coords.inRange( multi ) )
-      f( multi );
-  }
+  coords.forEachInRange( zone.multis, f );
 }
 }  // namespace Core
 }  // namespace Pol
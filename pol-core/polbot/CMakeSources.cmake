@@ -0,0 +1,9 @@
+set (polbot_sources  # sorted !
+  ../pol/ctable.cpp
+  ../pol/ctable.h
+  CMakeSources.cmake 
+  PolBotMain.cpp
+  PolBotMain.h
+  bot.cpp
+  bot.h
+)
@@ -0,0 +1,178 @@
+#include "PolBotMain.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <signal.h>
+#endif
+
+#include "../clib/Program/ProgramMain.h"
+#include "../clib/logfacility.h"
+#include "bot.h"
+#include <format/format.h>
+
+namespace Pol
+{
+namespace PolBot
+{
+namespace
+{
+unsigned int percentile( const std::vector<unsigned int>& sorted, unsigned int pct )
+{
+  if ( sorted.empty() )
+    return 0;
+  return sorted[std::min( sorted.size() - 1, sorted.size() * pct / 100 )];
+}
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+
+PolBotMain::PolBotMain() : Pol::Clib::ProgramMain() {}
+PolBotMain::~PolBotMain() {}
+///////////////////////////////////////////////////////////////////////////////
+
+void PolBotMain::showHelp()
+{
+  ERROR_PRINT << "Usage:\n"
+              << "    \n"
+              << "  POLBOT [options ...]\n"
+              << "    \n"
+              << "  Connects a number of headless clients to a running server, lets them walk,\n"
+              << "  talk and double click and reports the measured latencies.\n"
+              << "  The server must run without encryption (ClientEncryptionVersion=none) and\n"
+              << "  the accounts <account>1 .. <account>N need a character in the given slot.\n"
+              << "    \n"
+              << "  Options:\n"
+              << "    host=127.0.0.1         login server address\n"
+              << "    port=5003              login server port\n"
+              << "    bots=10                number of clients\n"
+              << "    account=bot            account name prefix\n"
+              << "    password=              password of all accounts\n"
+              << "    slot=0                 character slot\n"
+              << "    duration=60            seconds to run after the last login\n"
+              << "    walk=400               ms between walk requests, 0 disables\n"
+              << "    speech=5000            ms between speech, 0 disables\n"
+              << "    dblclick=3000          ms between double clicks, 0 disables\n"
+              << "    loginrate=50           ms between the logins of two clients\n"
+              << "    clientversion=7.0.15.1 reported client version\n";
+}
+
+int PolBotMain::main()
+{
+  const std::vector<std::string>& binArgs = programArgs();
+  if ( binArgs.size() > 1 && ( binArgs[1] == "-h" || binArgs[1] == "--help" ) )
+  {
+    showHelp();
+    return 0;
+  }
+
+#ifndef _WIN32
+  // a server closing the connection must not terminate the whole run
+  signal( SIGPIPE, SIG_IGN );
+#endif
+
+  BotConfig config;
+  config.host = programArgsFindEquals( "host=", std::string( "127.0.0.1" ) );
+  config.port = static_cast<unsigned short>( programArgsFindEquals( "port=", 5003, false ) );
+  config.password = programArgsFindEquals( "password=", std::string( "" ) );
+  config.slot = static_cast<unsigned int>( programArgsFindEquals( "slot=", 0, false ) );
+  config.clientversion = programArgsFindEquals( "clientversion=", std::string( "7.0.15.1" ) );
+  config.walk_ms = static_cast<unsigned int>( programArgsFindEquals( "walk=", 400, false ) );
+  config.speech_ms = static_cast<unsigned int>( programArgsFindEquals( "speech=", 5000, false ) );
+  config.dblclick_ms =
+      static_cast<unsigned int>( programArgsFindEquals( "dblclick=", 3000, false ) );
+  std::string account = programArgsFindEquals( "account=", std::string( "bot" ) );
+  int count = std::max( 1, programArgsFindEquals( "bots=", 10, false ) );
+  int duration = std::max( 1, programArgsFindEquals( "duration=", 60, false ) );
+  int loginrate = std::max( 0, programArgsFindEquals( "loginrate=", 50, false ) );
+
+  INFO_PRINT << "Starting " << count << " bots against " << config.host << ":" << config.port
+             << "\n";
+
+  std::atomic<bool> stop( false );
+  std::vector<std::unique_ptr<Bot>> bots;
+  std::vector<std::thread> threads;
+  for ( int i = 0; i < count; ++i )
+  {
+    config.account = account + std::to_string( i + 1 );
+    bots.emplace_back( new Bot( config, i + 1 ) );
+    Bot* bot = bots.back().get();
+    threads.emplace_back( [bot, &stop]() { bot->run( stop ); } );
+    if ( loginrate )
+      std::this_thread::sleep_for( std::chrono::milliseconds( loginrate ) );
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for( std::chrono::seconds( duration ) );
+  stop = true;
+  for ( auto& thread : threads )
+    thread.join();
+  double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+  BotStats total;
+  unsigned int in_world = 0;
+  std::map<std::string, unsigned int> errors;
+  for ( const auto& bot : bots )
+  {
+    const BotStats& stats = bot->stats();
+    if ( stats.in_world )
+      ++in_world;
+    if ( !stats.error.empty() )
+      ++errors[stats.error];
+    total.bytes_sent += stats.bytes_sent;
+    total.bytes_received += stats.bytes_received;
+    total.packets_sent += stats.packets_sent;
+    total.packets_received += stats.packets_received;
+    total.walks += stats.walks;
+    total.walks_denied += stats.walks_denied;
+    total.speeches += stats.speeches;
+    total.dblclicks += stats.dblclicks;
+    total.targets += stats.targets;
+    total.walk_latency_us.insert( total.walk_latency_us.end(), stats.walk_latency_us.begin(),
+                                  stats.walk_latency_us.end() );
+  }
+  std::sort( total.walk_latency_us.begin(), total.walk_latency_us.end() );
+  unsigned long long latency_sum = 0;
+  for ( auto latency : total.walk_latency_us )
+    latency_sum += latency;
+
+  fmt::Writer tmp;
+  tmp << "Bots in world: " << in_world << "/" << count << "\n";
+  for ( const auto& error : errors )
+    tmp << "  " << error.second << "x " << error.first << "\n";
+  tmp << "Walks: " << total.walks << " acked: " << total.walk_latency_us.size()
+      << " denied: " << total.walks_denied << "\n";
+  if ( !total.walk_latency_us.empty() )
+  {
+    tmp.Format( "Walk latency (us): avg {} p50 {} p90 {} p99 {} max {}\n" )
+        << latency_sum / total.walk_latency_us.size()
+        << percentile( total.walk_latency_us, 50 ) << percentile( total.walk_latency_us, 90 )
+        << percentile( total.walk_latency_us, 99 ) << total.walk_latency_us.back();
+  }
+  tmp << "Speech: " << total.speeches << " double clicks: " << total.dblclicks
+      << " targets: " << total.targets << "\n";
+  tmp.Format( "Packets/s sent {:.1f} received {:.1f}\n" ) << total.packets_sent / elapsed
+                                                          << total.packets_received / elapsed;
+  tmp.Format( "Bytes per client sent {} received {} (compressed)\n" )
+      << total.bytes_sent / count << total.bytes_received / count;
+  INFO_PRINT << tmp.str();
+  return in_world == static_cast<unsigned int>( count ) ? 0 : 1;
+}
+}  // namespace PolBot
+}  // namespace Pol
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+int main( int argc, char* argv[] )
+{
+  Pol::PolBot::PolBotMain* PolBotMain = new Pol::PolBot::PolBotMain();
+  PolBotMain->start( argc, argv );
+}
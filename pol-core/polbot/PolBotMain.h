@@ -0,0 +1,25 @@
+#ifndef POL_BOT_MAIN_H
+#define POL_BOT_MAIN_H
+
+#include "../clib/Program/ProgramMain.h"
+
+namespace Pol
+{
+namespace PolBot
+{
+class PolBotMain final : public Pol::Clib::ProgramMain
+{
+public:
+  PolBotMain();
+  virtual ~PolBotMain();
+
+protected:
+  virtual int main();
+
+private:
+  virtual void showHelp();
+};
+}
+}  // namespaces
+
+#endif  // POL_BOT_MAIN_H
@@ -0,0 +1,413 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#include "bot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "../clib/clib_endian.h"
+#include "../clib/logfacility.h"
+#include "../pol/network/pktboth.h"
+#include "../pol/network/pktbothid.h"
+#include "../pol/network/pktin.h"
+#include "../pol/network/pktinid.h"
+#include "../pol/network/pktoutid.h"
+
+namespace Pol
+{
+namespace PolBot
+{
+namespace
+{
+const unsigned int HANDSHAKE_TIMEOUT_MS = 10000;
+const size_t MAX_KNOWN_MOBILES = 32;
+
+u16 read_u16( const std::vector<u8>& pkt, size_t offset )
+{
+  return static_cast<u16>( ( pkt[offset] << 8 ) | pkt[offset + 1] );
+}
+
+u32 read_u32( const std::vector<u8>& pkt, size_t offset )
+{
+  return ( static_cast<u32>( pkt[offset] ) << 24 ) | ( pkt[offset + 1] << 16 ) |
+         ( pkt[offset + 2] << 8 ) | pkt[offset + 3];
+}
+}  // namespace
+
+BotStats::BotStats()
+    : in_world( false ),
+      error(),
+      bytes_sent( 0 ),
+      bytes_received( 0 ),
+      packets_sent( 0 ),
+      packets_received( 0 ),
+      walks( 0 ),
+      walks_denied( 0 ),
+      speeches( 0 ),
+      dblclicks( 0 ),
+      targets( 0 ),
+      walk_latency_us()
+{
+}
+
+Bot::Bot( const BotConfig& config, unsigned int id )
+    : _config( config ),
+      _id( id ),
+      _stats(),
+      _socket(),
+      _decoder(),
+      _packets(),
+      _rng( id ),
+      _relay_key( 0 ),
+      _relay_port( 0 ),
+      _charname(),
+      _charlist_received( false ),
+      _login_complete( false ),
+      _serial( 0 ),
+      _mobiles(),
+      _walk_seq( 0 ),
+      _walk_dir( 0 ),
+      _walk_pending( false ),
+      _walk_sent_at()
+{
+}
+
+void Bot::run( const std::atomic<bool>& stop )
+{
+  if ( !login() || !enter_world( stop ) )
+  {
+    _socket.close();
+    return;
+  }
+  _stats.in_world = true;
+  play( stop );
+  _socket.close();
+}
+
+bool Bot::fail( const std::string& error )
+{
+  if ( _stats.error.empty() )
+    _stats.error = error;
+  return false;
+}
+
+void Bot::send( const void* data, unsigned int len )
+{
+  _socket.send( data, len );
+  _stats.bytes_sent += len;
+  ++_stats.packets_sent;
+}
+
+bool Bot::recv_exact( void* data, unsigned int len )
+{
+  if ( !_socket.recvdata( data, len, HANDSHAKE_TIMEOUT_MS ) )
+    return fail( "login server closed the connection or timed out" );
+  _stats.bytes_received += len;
+  return true;
+}
+
+// Login server part, it talks uncompressed and ends with the relay to the game server.
+bool Bot::login()
+{
+  if ( !_socket.open( _config.host.c_str(), _config.port ) )
+    return fail( "unable to connect to the login server" );
+  _socket.disable_nagle();
+
+  u32 seed = ctBEu32( 0x7f000001 + _id );
+  send( &seed, sizeof seed );
+
+  Core::PKTIN_80 msg80;
+  memset( &msg80, 0, sizeof msg80 );
+  msg80.msgtype = Core::PKTIN_80_ID;
+  strncpy( msg80.name, _config.account.c_str(), sizeof msg80.name - 1 );
+  strncpy( msg80.password, _config.password.c_str(), sizeof msg80.password - 1 );
+  send( &msg80, sizeof msg80 );
+
+  for ( ;; )
+  {
+    u8 msgtype;
+    if ( !recv_exact( &msgtype, 1 ) )
+      return false;
+    if ( msgtype == Core::PKTOUT_82_ID )
+    {
+      u8 error;
+      recv_exact( &error, 1 );
+      return fail( "login denied, error " + std::to_string( error ) );
+    }
+    else if ( msgtype == Core::PKTOUT_A8_ID )
+    {
+      u8 header[2];
+      if ( !recv_exact( header, sizeof header ) )
+        return false;
+      std::vector<u8> rest( ( ( header[0] << 8 ) | header[1] ) - 3 );
+      if ( !recv_exact( rest.data(), static_cast<unsigned int>( rest.size() ) ) )
+        return false;
+      // u8 flags, u16 count, then the servers starting with their u16 index
+      if ( rest.size() < 5 || ( ( rest[1] << 8 ) | rest[2] ) == 0 )
+        return fail( "no game server available" );
+      Core::PKTIN_A0 msgA0;
+      msgA0.msgtype = Core::PKTIN_A0_ID;
+      msgA0.servernum = ctBEu16( static_cast<u16>( ( rest[3] << 8 ) | rest[4] ) );
+      send( &msgA0, sizeof msgA0 );
+    }
+    else if ( msgtype == Core::PKTOUT_8C_ID )
+    {
+      std::vector<u8> relay( 11 );
+      relay[0] = msgtype;
+      if ( !recv_exact( &relay[1], 10 ) )
+        return false;
+      // the ip is ignored, bots are meant to run against a local server
+      _relay_port = read_u16( relay, 5 );
+      _relay_key = read_u32( relay, 7 );
+      _socket.close();
+      return true;
+    }
+    else
+      return fail( "unexpected packet from the login server" );
+  }
+}
+
+// Game server part, everything the server sends from here on is compressed.
+bool Bot::enter_world( const std::atomic<bool>& stop )
+{
+  if ( !_socket.open( _config.host.c_str(), _relay_port ) )
+    return fail( "unable to connect to the game server" );
+  _socket.disable_nagle();
+
+  u32 key = ctBEu32( _relay_key );
+  send( &key, sizeof key );
+
+  Core::PKTIN_91 msg91;
+  memset( &msg91, 0, sizeof msg91 );
+  msg91.msgtype = Core::PKTIN_91_ID;
+  memcpy( &msg91.unk1, &key, sizeof key );
+  strncpy( msg91.name, _config.account.c_str(), sizeof msg91.name - 1 );
+  strncpy( msg91.password, _config.password.c_str(), sizeof msg91.password - 1 );
+  send( &msg91, sizeof msg91 );
+
+  auto timeout = clock::now() + std::chrono::milliseconds( HANDSHAKE_TIMEOUT_MS );
+  while ( !_charlist_received )
+  {
+    if ( stop || clock::now() > timeout )
+      return fail( "no character list received" );
+    if ( !receive( 100 ) )
+      return false;
+  }
+  if ( _charname.empty() )
+    return fail( "no character in slot " + std::to_string( _config.slot ) );
+
+  Core::PKTIN_5D msg5D;
+  memset( &msg5D, 0, sizeof msg5D );
+  msg5D.msgtype = Core::PKTIN_5D_ID;
+  msg5D.pattern_EDEDEDED = 0xEDEDEDED;
+  strncpy( msg5D.charname, _charname.c_str(), sizeof msg5D.charname - 1 );
+  msg5D.charidx = ctBEu32( _config.slot );
+  send( &msg5D, sizeof msg5D );
+
+  timeout = clock::now() + std::chrono::milliseconds( HANDSHAKE_TIMEOUT_MS );
+  while ( !_login_complete )
+  {
+    if ( stop || clock::now() > timeout )
+      return fail( "login was not completed" );
+    if ( !receive( 100 ) )
+      return false;
+  }
+  return true;
+}
+
+void Bot::play( const std::atomic<bool>& stop )
+{
+  auto next_action = [this]( unsigned int interval_ms ) {
+    // spread the first actions of all bots over the interval
+    return clock::now() + std::chrono::milliseconds( interval_ms ? _rng() % interval_ms : 0 );
+  };
+  clock::time_point next_walk = next_action( _config.walk_ms );
+  clock::time_point next_speech = next_action( _config.speech_ms );
+  clock::time_point next_dblclick = next_action( _config.dblclick_ms );
+
+  while ( !stop )
+  {
+    if ( !receive( 10 ) )
+      return;
+    auto now = clock::now();
+    // the next step is only requested after the last one got acknowledged, like the client does
+    if ( _config.walk_ms && !_walk_pending && now >= next_walk )
+    {
+      send_walk();
+      next_walk = now + std::chrono::milliseconds( _config.walk_ms );
+    }
+    if ( _config.speech_ms && now >= next_speech )
+    {
+      send_speech();
+      next_speech = now + std::chrono::milliseconds( _config.speech_ms );
+    }
+    if ( _config.dblclick_ms && now >= next_dblclick )
+    {
+      send_dblclick();
+      next_dblclick = now + std::chrono::milliseconds( _config.dblclick_ms );
+    }
+  }
+}
+
+bool Bot::receive( unsigned int waitms )
+{
+  if ( !_socket.has_incoming_data( waitms ) )
+  {
+    if ( !_socket.connected() )
+      return fail( "game server closed the connection" );
+    return true;
+  }
+  char buffer[4096];
+  int count;
+  if ( !_socket.recvdata_nowait( buffer, sizeof buffer, &count ) )
+    return fail( "game server closed the connection" );
+  _stats.bytes_received += count;
+  if ( !_decoder.decode( reinterpret_cast<unsigned char*>( buffer ), count, &_packets ) )
+    return fail( "invalid compressed data from the game server" );
+  for ( const auto& pkt : _packets )
+  {
+    ++_stats.packets_received;
+    if ( !pkt.empty() )
+      handle( pkt );
+  }
+  _packets.clear();
+  return true;
+}
+
+void Bot::handle( const std::vector<u8>& pkt )
+{
+  switch ( pkt[0] )
+  {
+  case Core::PKTOUT_A9_ID:
+    // u16 len, u8 count, then 60 bytes name and password per slot
+    if ( pkt.size() > 4 + ( _config.slot + 1 ) * 60 && _config.slot < pkt[3] )
+    {
+      const char* name = reinterpret_cast<const char*>( &pkt[4 + _config.slot * 60] );
+      _charname.assign( name, strnlen( name, 30 ) );
+    }
+    _charlist_received = true;
+    break;
+  case Core::PKTOUT_1B_ID:
+    if ( pkt.size() >= 5 )
+      _serial = read_u32( pkt, 1 );
+    break;
+  case Core::PKTOUT_55_ID:
+    _login_complete = true;
+    break;
+  case Core::PKTBI_BD_ID:
+  {
+    // client version request
+    std::vector<u8> msg( 3 );
+    msg[0] = Core::PKTBI_BD_ID;
+    msg.insert( msg.end(), _config.clientversion.begin(), _config.clientversion.end() );
+    msg.push_back( 0 );
+    msg[1] = static_cast<u8>( msg.size() >> 8 );
+    msg[2] = static_cast<u8>( msg.size() );
+    send( msg.data(), static_cast<unsigned int>( msg.size() ) );
+    break;
+  }
+  case Core::PKTBI_22_APPROVED_ID:
+    if ( _walk_pending && pkt.size() >= 2 && pkt[1] == _walk_seq )
+    {
+      _stats.walk_latency_us.push_back( static_cast<unsigned int>(
+          std::chrono::duration_cast<std::chrono::microseconds>( clock::now() - _walk_sent_at )
+              .count() ) );
+      _walk_pending = false;
+      _walk_seq = _walk_seq == 255 ? 1 : _walk_seq + 1;
+    }
+    break;
+  case Core::PKTOUT_21_ID:
+    ++_stats.walks_denied;
+    _walk_pending = false;
+    _walk_seq = 0;
+    _walk_dir = static_cast<u8>( _rng() % 8 );
+    break;
+  case Core::PKTBI_6C_ID:
+    if ( pkt.size() >= sizeof( Core::PKTBI_6C ) )
+    {
+      // answer every target cursor with the own character
+      Core::PKTBI_6C msg6C;
+      memcpy( &msg6C, pkt.data(), sizeof msg6C );
+      msg6C.cursor_type = Core::PKTBI_6C::CURSOR_TYPE_OBJECT;
+      msg6C.selected_serial = ctBEu32( _serial );
+      send( &msg6C, sizeof msg6C );
+      ++_stats.targets;
+    }
+    break;
+  case Core::PKTOUT_77_ID:
+  case Core::PKTOUT_78_ID:
+  {
+    // 0x78 has the length in front of the serial
+    size_t offset = pkt[0] == Core::PKTOUT_78_ID ? 3 : 1;
+    if ( pkt.size() < offset + 4 )
+      break;
+    u32 serial = read_u32( pkt, offset ) & 0x7FFFFFFF;
+    if ( serial != _serial && _mobiles.size() < MAX_KNOWN_MOBILES &&
+         std::find( _mobiles.begin(), _mobiles.end(), serial ) == _mobiles.end() )
+      _mobiles.push_back( serial );
+    break;
+  }
+  case Core::PKTOUT_1D_ID:
+    if ( pkt.size() >= 5 )
+    {
+      auto itr = std::find( _mobiles.begin(), _mobiles.end(), read_u32( pkt, 1 ) );
+      if ( itr != _mobiles.end() )
+        _mobiles.erase( itr );
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+void Bot::send_walk()
+{
+  // keep the direction for a few steps, the first step into a new direction only turns
+  if ( _rng() % 8 == 0 )
+    _walk_dir = static_cast<u8>( _rng() % 8 );
+  Core::PKTIN_02 msg02;
+  msg02.msgtype = Core::PKTIN_02_ID;
+  msg02.dir = _walk_dir;
+  msg02.movenum = _walk_seq;
+  msg02.codes = 0;
+  send( &msg02, sizeof msg02 );
+  _walk_pending = true;
+  _walk_sent_at = clock::now();
+  ++_stats.walks;
+}
+
+void Bot::send_speech()
+{
+  std::string text = "bot " + std::to_string( _id ) + " step " + std::to_string( _stats.walks );
+  std::vector<u8> msg( 8 );
+  msg[0] = Core::PKTIN_03_ID;
+  msg[3] = 0;     // type regular
+  msg[4] = 0x03;  // color 0x3b2
+  msg[5] = 0xb2;
+  msg[6] = 0;  // font 3
+  msg[7] = 3;
+  msg.insert( msg.end(), text.begin(), text.end() );
+  msg.push_back( 0 );
+  msg[1] = static_cast<u8>( msg.size() >> 8 );
+  msg[2] = static_cast<u8>( msg.size() );
+  send( msg.data(), static_cast<unsigned int>( msg.size() ) );
+  ++_stats.speeches;
+}
+
+void Bot::send_dblclick()
+{
+  Core::PKTIN_06 msg06;
+  msg06.msgtype = Core::PKTIN_06_ID;
+  u32 serial = _mobiles.empty() ? _serial : _mobiles[_rng() % _mobiles.size()];
+  msg06.serial = ctBEu32( serial );
+  send( &msg06, sizeof msg06 );
+  ++_stats.dblclicks;
+}
+}  // namespace PolBot
+}  // namespace Pol
@@ -0,0 +1,110 @@
+/** @file
+ *
+ * @par History
+ */
+
+
+#ifndef POLBOT_BOT_H
+#define POLBOT_BOT_H
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../clib/network/wnsckt.h"
+#include "../clib/rawtypes.h"
+#include "../pol/ctable.h"
+
+namespace Pol
+{
+namespace PolBot
+{
+struct BotConfig
+{
+  std::string host;
+  unsigned short port;
+  std::string account;
+  std::string password;
+  unsigned int slot;
+  std::string clientversion;
+  // intervals of the actions in milliseconds, 0 disables them
+  unsigned int walk_ms;
+  unsigned int speech_ms;
+  unsigned int dblclick_ms;
+};
+
+struct BotStats
+{
+  BotStats();
+
+  bool in_world;
+  std::string error;
+  unsigned long long bytes_sent;
+  unsigned long long bytes_received;  // as received, the game server stream is compressed
+  unsigned int packets_sent;
+  unsigned int packets_received;
+  unsigned int walks;
+  unsigned int walks_denied;
+  unsigned int speeches;
+  unsigned int dblclicks;
+  unsigned int targets;
+  std::vector<unsigned int> walk_latency_us;  // walk request until the walk ack
+};
+
+// One simulated client. Logs in over the login and game server handshake (without encryption),
+// enters the world with a character of the account and walks, talks, double clicks and answers
+// target cursors until stopped.
+class Bot
+{
+public:
+  Bot( const BotConfig& config, unsigned int id );
+  Bot( const Bot& ) = delete;
+  Bot& operator=( const Bot& ) = delete;
+
+  void run( const std::atomic<bool>& stop );
+  const BotStats& stats() const { return _stats; }
+
+private:
+  typedef std::chrono::steady_clock clock;
+
+  bool login();
+  bool enter_world( const std::atomic<bool>& stop );
+  void play( const std::atomic<bool>& stop );
+
+  bool recv_exact( void* data, unsigned int len );
+  // reads from the game server and handles all completed packets
+  bool receive( unsigned int waitms );
+  void handle( const std::vector<u8>& pkt );
+  void send( const void* data, unsigned int len );
+  bool fail( const std::string& error );
+
+  void send_walk();
+  void send_speech();
+  void send_dblclick();
+
+  BotConfig _config;
+  unsigned int _id;
+  BotStats _stats;
+  Clib::Socket _socket;
+  Core::HuffmanDecoder _decoder;
+  std::vector<std::vector<u8>> _packets;
+  std::mt19937 _rng;
+
+  u32 _relay_key;
+  unsigned short _relay_port;
+  std::string _charname;
+  bool _charlist_received;
+  bool _login_complete;
+  u32 _serial;
+  std::vector<u32> _mobiles;  // seen mobiles, used for double clicks
+
+  u8 _walk_seq;
+  u8 _walk_dir;
+  bool _walk_pending;
+  clock::time_point _walk_sent_at;
+};
+}  // namespace PolBot
+}  // namespace Pol
+#endif